@@ -1,112 +1,112 @@
 ﻿#include "AnimationSystem.hpp"
 
 #include "Repository.hpp"
+#include "SystemContext.hpp"
 #include "Events/EventBus.hpp"
 #include "Events/Events.hpp"
 
 
 namespace gestalt::application {
 
+  namespace {
+    /** Advances the channel and returns the samples to blend, looping after the last one. */
+    template <typename V>
+    typename CompiledTrack<V>::Sample advance(AnimationChannel<V>& channel, const float delta_time,
+                                              const bool loop) {
+      const CompiledTrack<V>& track = *channel.track;
+      float current_time = channel.current_time + delta_time;
+      const auto sample = track.locate(current_time, channel.cursor);
+
+      if (loop && current_time > track.end_time) {
+        current_time = 0.0f;  // Reset for looping
+      }
+      channel.current_time = current_time;
+      return sample;
+    }
+  }  // namespace
+
   AnimationSystem::AnimationSystem(Repository& repository, EventBus& event_bus)
       : repository_(repository), event_bus_(event_bus) {}
 
-  glm::vec3 AnimationSystem::update_translation(const Entity& entity,
-                                                AnimationChannel<glm::vec3>& translation_channel,
-                                                bool loop) const {
-    const auto& translation_keyframes = translation_channel.keyframes;
-    float current_time = translation_channel.current_time;
-    current_time += delta_time_;
-
-    if (translation_keyframes.size() < 2) {
-      return translation_keyframes[0].value;  // Not enough keyframes to interpolate
+  void AnimationSystem::sample(const size_t i, AnimationComponent& animation_component) {
+    auto& translation_channel = animation_component.translation_channel;
+    auto& rotation_channel = animation_component.rotation_channel;
+    auto& scale_channel = animation_component.scale_channel;
+    const bool loop = animation_component.loop;
+    uint8 sampled = 0;
+
+    glm::vec3 from_position(0.f);
+    glm::vec3 to_position(0.f);
+    weights_.position[i] = 0.f;
+    if (!translation_channel.track->empty()) {
+      const auto& values = translation_channel.track->values;
+      const auto sample = advance(translation_channel, delta_time_, loop);
+      from_position = values[sample.from];
+      to_position = values[sample.to];
+      weights_.position[i] = sample.weight;
+      sampled |= kTranslation;
     }
 
-    // Find the keyframe pair that surrounds the current time
-    size_t start_index = 0;
-    size_t end_index = 1;
-
-    for (size_t i = 0; i < translation_keyframes.size() - 1; ++i) {
-      if (current_time >= translation_keyframes[i].time
-          && current_time <= translation_keyframes[i + 1].time) {
-        start_index = i;
-        end_index = i + 1;
-        break;
-      }
+    glm::quat from_rotation(1.f, 0.f, 0.f, 0.f);
+    glm::quat to_rotation(1.f, 0.f, 0.f, 0.f);
+    weights_.rotation[i] = 0.f;
+    if (!rotation_channel.track->empty()) {
+      const auto& values = rotation_channel.track->values;
+      const auto sample = advance(rotation_channel, delta_time_, loop);
+      from_rotation = values[sample.from];
+      to_rotation = values[sample.to];
+      weights_.rotation[i] = sample.weight;
+      sampled |= kRotation;
     }
 
-    // Get the two keyframes
-    auto& start_keyframe = translation_keyframes[start_index];
-    auto& end_keyframe = translation_keyframes[end_index];
-
-    // Compute the interpolation factor (t) between the start and end keyframes
-    const float32 t
-        = (current_time - start_keyframe.time) / (end_keyframe.time - start_keyframe.time);
-
-    // Linearly interpolate the translation between the two keyframes
-    const glm::vec3 interpolated_translation = mix(start_keyframe.value, end_keyframe.value, t);
-
-    if (loop && current_time > translation_keyframes.back().time) {
-      current_time = 0.0f;  // Reset for looping
+    // transforms carry a uniform scale, taken from x as TransformComponent::set_scale does
+    float32 from_scale = 1.f;
+    float32 to_scale = 1.f;
+    weights_.scale[i] = 0.f;
+    if (!scale_channel.track->empty()) {
+      const auto& values = scale_channel.track->values;
+      const auto sample = advance(scale_channel, delta_time_, loop);
+      from_scale = values[sample.from].x;
+      to_scale = values[sample.to].x;
+      weights_.scale[i] = sample.weight;
+      sampled |= kScale;
     }
-    translation_channel.current_time = current_time;
 
-    return interpolated_translation;
+    from_batch_.set(i, from_position, from_rotation, from_scale);
+    to_batch_.set(i, to_position, to_rotation, to_scale);
+    sampled_[i] = sampled;
   }
 
-  glm::quat AnimationSystem::update_rotation(const Entity& entity,
-                                             AnimationChannel<glm::quat>& rotation_channel,
-                                             bool loop) const {
-    const auto& rotation_keyframes = rotation_channel.keyframes;
-    float current_time = rotation_channel.current_time;
-    current_time += delta_time_;
+  void AnimationSystem::update(const SystemContext& context, const float delta_time) {
+    delta_time_ = delta_time;
 
-    if (rotation_keyframes.size() < 2) {
-      return rotation_keyframes[0].value;  // Not enough keyframes to interpolate
+    // sample every clip into batches, blend them all at once and then publish the results
+    auto& animations = context.write<AnimationComponent>();
+    const size_t count = animations.size();
+    from_batch_.resize(count);
+    to_batch_.resize(count);
+    weights_.resize(count);
+    sampled_.resize(count);
+
+    const auto components = animations.components();
+    for (size_t i = 0; i < count; ++i) {
+      sample(i, components[i]);
     }
 
-    // Find the keyframe pair that surrounds the current time
-    size_t start_index = 0;
-    size_t end_index = 1;
-
-    for (size_t i = 0; i < rotation_keyframes.size() - 1; ++i) {
-      if (current_time >= rotation_keyframes[i].time
-          && current_time <= rotation_keyframes[i + 1].time) {
-        start_index = i;
-        end_index = i + 1;
-        break;
+    blend_transforms(from_batch_, to_batch_, weights_, blended_batch_);
+
+    const auto entities = animations.entities();
+    for (size_t i = 0; i < count; ++i) {
+      uint8 fields = 0;
+      fields |= sampled_[i] & kTranslation ? TransformEntityEvent::kPosition : 0;
+      fields |= sampled_[i] & kRotation ? TransformEntityEvent::kRotation : 0;
+      fields |= sampled_[i] & kScale ? TransformEntityEvent::kScale : 0;
+      if (fields != 0) {
+        event_bus_.emit<TransformEntityEvent>(TransformEntityEvent{
+            entities[i], fields, blended_batch_.position(i), blended_batch_.rotation(i),
+            blended_batch_.scale[i]});
       }
     }
-
-    // Get the two keyframes
-    auto& start_keyframe = rotation_keyframes[start_index];
-    auto& end_keyframe = rotation_keyframes[end_index];
-
-    // Compute the interpolation factor (t) between the start and end keyframes
-    const float32 t
-        = (current_time - start_keyframe.time) / (end_keyframe.time - start_keyframe.time);
-
-    // Linearly interpolate the translation between the two keyframes
-    const glm::quat interpolated_rotation = glm::mix(start_keyframe.value, end_keyframe.value, t);
-
-    if (loop && current_time > rotation_keyframes.back().time) {
-      current_time = 0.0f;  // Reset for looping
-    }
-    rotation_channel.current_time = current_time;
-
-    return glm::normalize(interpolated_rotation);
-  }
-
-  void AnimationSystem::update(const float delta_time) {
-    delta_time_ = delta_time;
-    for (auto [entity, animation_component] : repository_.animation_components.snapshot()) {
-      const auto new_translation = update_translation(
-          entity, animation_component.translation_channel, animation_component.loop);
-      const auto new_rotation
-          = update_rotation(entity, animation_component.rotation_channel, animation_component.loop);
-      event_bus_.emit<TranslateEntityEvent>(TranslateEntityEvent{entity, new_translation});
-      event_bus_.emit<RotateEntityEvent>(RotateEntityEvent{entity, new_rotation});
-
-    }
   }
 
 }  // namespace gestalt::application
\ No newline at end of file
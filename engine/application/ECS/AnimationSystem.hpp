@@ -1,28 +1,39 @@
 ﻿#pragma once
 
-#include "Animation/AnimationChannel.hpp"
+#include <vector>
+
+#include "TransformBatch.hpp"
 #include "Components/Entity.hpp"
-#include <glm/fwd.hpp>
 
 namespace gestalt::application {
   class EventBus;
+  class SystemContext;
 }
 
 namespace gestalt::foundation {
   class Repository;
+  struct AnimationComponent;
 }
 
 namespace gestalt::application {
 
   class AnimationSystem final {
+    static constexpr uint8 kTranslation = 1;
+    static constexpr uint8 kRotation = 2;
+    static constexpr uint8 kScale = 4;
+
     Repository& repository_;
     EventBus& event_bus_;
     float delta_time_ = 0.0f;
-    glm::vec3 update_translation(const Entity& entity,
-                                 AnimationChannel<glm::vec3>& translation_channel,
-                            bool loop) const;
-    glm::quat update_rotation(const Entity& entity, AnimationChannel<glm::quat>& rotation_channel,
-                         bool loop) const;
+
+    // per animation component: the samples around the current time and how to blend them
+    TransformBatch from_batch_;
+    TransformBatch to_batch_;
+    BlendWeights weights_;
+    TransformBatch blended_batch_;
+    std::vector<uint8> sampled_;  // kTranslation | kRotation | kScale for the channels with keys
+
+    void sample(size_t i, AnimationComponent& animation_component);
 
   public:
     explicit AnimationSystem(Repository& repository, EventBus& event_bus);
@@ -34,7 +45,7 @@ namespace gestalt::application {
     AnimationSystem(AnimationSystem&&) = delete;
     AnimationSystem& operator=(AnimationSystem&&) = delete;
 
-    void update(float delta_time);
+    void update(const SystemContext& context, float delta_time);
   };
 
 }  // namespace gestalt::application
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "FrameProvider.hpp"
 #include "PerFrameData.hpp"
 #include "Repository.hpp"
+#include "SystemContext.hpp"
 #include "VulkanTypes.hpp"
 #include "Interface/IGpu.hpp"
 #include "Interface/IResourceAllocator.hpp"
@@ -100,58 +101,53 @@ namespace gestalt::application {
                        0.0f,           0.0f, 0.0f, 1.0f, 0.0f, 0.0f, zNear, 0.0f};
     }
 
-    void CameraSystem::update(const float delta_time, const UserInput& movement, float aspect) {
+    void CameraSystem::update(const SystemContext& context, const float delta_time,
+                              const UserInput& movement, float aspect) {
       aspect_ratio_ = aspect;
+      auto& animation_cameras = context.write<AnimationCameraComponent>();
+      auto& first_person_cameras = context.write<FirstPersonCameraComponent>();
+      auto& free_fly_cameras = context.write<FreeFlyCameraComponent>();
+      auto& orbit_cameras = context.write<OrbitCameraComponent>();
 
     // TODO set this based on camera create event
-      if (!repository_.animation_camera_components.find(active_camera_)
-          && !repository_.first_person_camera_components.find(active_camera_)
-          && !repository_.free_fly_camera_components.find(active_camera_)
-          && !repository_.orbit_camera_components.find(active_camera_)) {
-        if (const auto cameras = repository_.animation_camera_components.snapshot();
-            !cameras.empty()) {
-          active_camera_ = cameras.front().first;
-        } else if (const auto cameras = repository_.first_person_camera_components.snapshot();
-                   !cameras.empty()) {
-          active_camera_ = cameras.front().first;
-        } else if (const auto cameras = repository_.free_fly_camera_components.snapshot();
-                   !cameras.empty()) {
-          active_camera_ = cameras.front().first;
-        } else if (const auto cameras = repository_.orbit_camera_components.snapshot();
-                   !cameras.empty()) {
-          active_camera_ = cameras.front().first;
+      if (!animation_cameras.find(active_camera_) && !first_person_cameras.find(active_camera_)
+          && !free_fly_cameras.find(active_camera_) && !orbit_cameras.find(active_camera_)) {
+        if (const auto cameras = animation_cameras.entities(); !cameras.empty()) {
+          active_camera_ = cameras.front();
+        } else if (const auto cameras = first_person_cameras.entities(); !cameras.empty()) {
+          active_camera_ = cameras.front();
+        } else if (const auto cameras = free_fly_cameras.entities(); !cameras.empty()) {
+          active_camera_ = cameras.front();
+        } else if (const auto cameras = orbit_cameras.entities(); !cameras.empty()) {
+          active_camera_ = cameras.front();
         }
       }
 
-      auto transform_component = repository_.transform_components.find(active_camera_);
+      auto transform_component = context.read<TransformComponent>().find(active_camera_);
       auto view_matrix = glm::mat4(1.0f);
-      if (const auto camera_component
-          = repository_.free_fly_camera_components.find_mutable(active_camera_);
+      if (const auto camera_component = free_fly_cameras.find_mutable(active_camera_);
           camera_component != nullptr) {
         camera_component->update(delta_time, movement);
         view_matrix = camera_component->view_matrix();
-        event_bus_.emit<MoveEntityEvent>(
-            MoveEntityEvent{active_camera_, camera_component->position(),
-                            camera_component->orientation(), transform_component->scale_uniform()});
-      } else if (const auto camera_component
-                 = repository_.orbit_camera_components.find_mutable(active_camera_);
+        event_bus_.emit<TransformEntityEvent>(
+            {active_camera_, TransformEntityEvent::kPosition | TransformEntityEvent::kRotation,
+             camera_component->position(), camera_component->orientation(), 1.f});
+      } else if (const auto camera_component = orbit_cameras.find_mutable(active_camera_);
                  camera_component != nullptr) {
         camera_component->update(delta_time, movement);
         view_matrix = camera_component->view_matrix();
-        event_bus_.emit<MoveEntityEvent>(
-            MoveEntityEvent{active_camera_, camera_component->position(),
-                            camera_component->orientation(), transform_component->scale_uniform()});
-      } else if (const auto camera_component
-                 = repository_.first_person_camera_components.find_mutable(active_camera_);
+        event_bus_.emit<TransformEntityEvent>(
+            {active_camera_, TransformEntityEvent::kPosition | TransformEntityEvent::kRotation,
+             camera_component->position(), camera_component->orientation(), 1.f});
+      } else if (const auto camera_component = first_person_cameras.find_mutable(active_camera_);
                  camera_component != nullptr) {
         camera_component->set_position(transform_component->position());
         camera_component->update(movement);
         view_matrix = camera_component->view_matrix();
-        event_bus_.emit<MoveEntityEvent>(
-            MoveEntityEvent{active_camera_, camera_component->position(),
-                            camera_component->orientation(), transform_component->scale_uniform()});
-      } else if (const auto camera_component
-                 = repository_.animation_camera_components.find_mutable(active_camera_);
+        event_bus_.emit<TransformEntityEvent>(
+            {active_camera_, TransformEntityEvent::kPosition | TransformEntityEvent::kRotation,
+             camera_component->position(), camera_component->orientation(), 1.f});
+      } else if (const auto camera_component = animation_cameras.find_mutable(active_camera_);
                  camera_component != nullptr) {
         camera_component->set_position(transform_component->position());
         camera_component->set_orientation(transform_component->rotation());
@@ -168,12 +164,12 @@ namespace gestalt::application {
     glm::mat4 projection{1.0f};
 
     if (const auto camera_component
-        = repository_.perspective_projection_components.find_mutable(active_camera_);
+        = context.write<PerspectiveProjectionComponent>().find_mutable(active_camera_);
         camera_component != nullptr) {
       camera_component->set_aspect_ratio(aspect_ratio_);
       projection = camera_component->projection_matrix();
     } else if (const auto camera_component
-               = repository_.orthographic_projection_components.find_mutable(active_camera_);
+               = context.write<OrthographicProjectionComponent>().find_mutable(active_camera_);
                camera_component != nullptr) {
       projection = camera_component->projection_matrix();
     }
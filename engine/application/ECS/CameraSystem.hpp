@@ -3,6 +3,7 @@
 
 namespace gestalt::application {
   class EventBus;
+  class SystemContext;
 }
 
 namespace gestalt::foundation {
@@ -39,7 +40,8 @@ namespace gestalt::application {
     void set_active_camera(const Entity camera) { active_camera_ = camera; }
     [[nodiscard]] Entity get_active_camera() const { return active_camera_; }
 
-    void update(float delta_time, const UserInput& movement, float aspect);
+    void update(const SystemContext& context, float delta_time, const UserInput& movement,
+                float aspect);
   };
 
 }  // namespace gestalt::application
\ No newline at end of file
@@ -0,0 +1,68 @@
+﻿#include "CommandBuffer.hpp"
+
+#include "ComponentFactory.hpp"
+
+namespace gestalt::application {
+
+  CommandBuffer::Pending CommandBuffer::create_entity(std::string name, const glm::vec3& position,
+                                                      const glm::quat& rotation,
+                                                      const float32 scale) {
+    commands_.emplace_back(Create{std::move(name), position, rotation, scale});
+    return Pending{created_++};
+  }
+
+  void CommandBuffer::destroy_entity(const Target entity) {
+    commands_.emplace_back(Destroy{entity});
+  }
+
+  void CommandBuffer::set_parent(const Target child, const Target parent) {
+    commands_.emplace_back(SetParent{child, parent});
+  }
+
+  CommandBuffer& CommandQueue::buffer(const uint64 key) {
+    std::lock_guard lock(mutex_);
+    return buffers_[key];
+  }
+
+  void CommandQueue::play_back(Repository& repository, ComponentFactory& component_factory,
+                               const std::function<void(Entity)>& destroy_entity) {
+    std::lock_guard lock(mutex_);
+    for (auto& [key, buffer] : buffers_) {
+      // pending handles are indices into the entities this buffer created so far
+      created_.clear();
+      const auto resolve = [this](const CommandBuffer::Target& target) {
+        if (const auto entity = std::get_if<Entity>(&target); entity != nullptr) {
+          return *entity;
+        }
+        const uint32 index = std::get<CommandBuffer::Pending>(target).index;
+        return index < created_.size() ? created_[index] : invalid_entity;
+      };
+
+      for (auto& command : buffer.commands_) {
+        std::visit(
+            [&]<typename Command>(Command& recorded) {
+              if constexpr (std::is_same_v<Command, CommandBuffer::Create>) {
+                const auto [entity, node] = component_factory.create_entity(
+                    recorded.name, recorded.position, recorded.rotation, recorded.scale);
+                component_factory.link_entity_to_parent(entity, root_entity);
+                created_.push_back(entity);
+              } else if constexpr (std::is_same_v<Command, CommandBuffer::Destroy>) {
+                destroy_entity(resolve(recorded.entity));
+              } else if constexpr (std::is_same_v<Command, CommandBuffer::SetParent>) {
+                component_factory.link_entity_to_parent(resolve(recorded.child),
+                                                        resolve(recorded.parent));
+              } else {
+                // the entity may have been destroyed by an earlier command
+                if (const Entity entity = resolve(recorded.entity);
+                    component_factory.is_alive(entity)) {
+                  recorded.apply(repository, entity);
+                }
+              }
+            },
+            command);
+      }
+    }
+    buffers_.clear();
+  }
+
+}  // namespace gestalt::application
@@ -0,0 +1,135 @@
+﻿#pragma once
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "common.hpp"
+#include "Repository.hpp"
+#include "Components/Entity.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/vec3.hpp"
+
+namespace gestalt::application {
+  class ComponentFactory;
+
+  /**
+   * @brief Structural changes recorded by one thread, applied later on the main thread.
+   *
+   * Entities created through the buffer exist only as Pending handles until playback, every other
+   * command accepts either a live Entity or such a Pending handle of the same buffer. Commands are
+   * applied in recording order.
+   */
+  class CommandBuffer final {
+  public:
+    struct Pending {
+      uint32 index;
+    };
+    using Target = std::variant<Entity, Pending>;
+
+    CommandBuffer() = default;
+    ~CommandBuffer() = default;
+
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+    CommandBuffer(CommandBuffer&&) = default;
+    CommandBuffer& operator=(CommandBuffer&&) = default;
+
+    /** @brief Creates an entity below the root node. */
+    Pending create_entity(std::string name = {}, const glm::vec3& position = glm::vec3(0.f),
+                          const glm::quat& rotation = glm::quat(1.f, 0.f, 0.f, 0.f),
+                          float32 scale = 1.f);
+
+    /** @brief Destroys the entity and its subtree. */
+    void destroy_entity(Target entity);
+    void set_parent(Target child, Target parent);
+
+    template <typename T> void add_component(const Target entity, T component) {
+      commands_.emplace_back(Apply{
+          entity, [component = std::move(component)](Repository& repository, const Entity target) {
+            if constexpr (std::is_empty_v<T>) {
+              repository.storage<T>().add(target);
+            } else {
+              repository.storage<T>().upsert(target, component);
+            }
+          }});
+    }
+
+    template <typename T> void remove_component(const Target entity) {
+      commands_.emplace_back(Apply{entity, [](Repository& repository, const Entity target) {
+                                     repository.storage<T>().remove(target);
+                                   }});
+    }
+
+    [[nodiscard]] bool empty() const { return commands_.empty(); }
+    [[nodiscard]] size_t size() const { return commands_.size(); }
+
+  private:
+    friend class CommandQueue;
+
+    struct Create {
+      std::string name;
+      glm::vec3 position;
+      glm::quat rotation;
+      float32 scale;
+    };
+    struct Destroy {
+      Target entity;
+    };
+    struct SetParent {
+      Target child;
+      Target parent;
+    };
+    struct Apply {
+      Target entity;
+      std::function<void(Repository&, Entity)> apply;
+    };
+    using Command = std::variant<Create, Destroy, SetParent, Apply>;
+
+    std::vector<Command> commands_;
+    uint32 created_ = 0;
+  };
+
+  /**
+   * @brief Collects the command buffers of all threads and plays them back at the sync points of
+   * EntityComponentSystem::update_scene.
+   *
+   * Each buffer is requested under a key, e.g. the index of the job or batch that records into it.
+   * Playback visits the buffers in ascending key order, so the result does not depend on which
+   * thread finished first. A key must only be recorded into by one thread at a time.
+   */
+  class CommandQueue final {
+    std::mutex mutex_;
+    std::map<uint64, CommandBuffer> buffers_;  // nodes, so handed out buffers stay in place
+    std::vector<Entity> created_;
+
+  public:
+    CommandQueue() = default;
+    ~CommandQueue() = default;
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    CommandQueue(CommandQueue&&) = delete;
+    CommandQueue& operator=(CommandQueue&&) = delete;
+
+    /**
+     * @brief Returns the buffer for key, creating it if needed. Thread-safe, the buffer stays valid
+     * until the next play_back.
+     */
+    [[nodiscard]] CommandBuffer& buffer(uint64 key);
+
+    /**
+     * @brief Applies and clears all buffers. Must run on the main thread while no thread records.
+     * destroy_entity is called for destroy commands so subtrees and physics bodies are released.
+     */
+    void play_back(Repository& repository, ComponentFactory& component_factory,
+                   const std::function<void(Entity)>& destroy_entity);
+  };
+
+}  // namespace gestalt::application
@@ -2,6 +2,9 @@
 #include "ComponentFactory.hpp"
 
 #include <fmt/core.h>
+#include <limits>
+#include <optional>
+#include <unordered_map>
 
 #include "Repository.hpp"
 #include "Animation/Keyframe.hpp"
@@ -68,29 +71,24 @@ namespace gestalt::application {
 
   ComponentFactory::ComponentFactory(Repository& repository, EventBus& event_bus)
       : repository_(repository), event_bus_(event_bus) {
-    auto [entity, root_node] = create_entity();
-    root_node->name = "root";
+    create_entity("root");
   }
 
-    Entity ComponentFactory::next_entity() { return next_entity_id_++; }
+    Entity ComponentFactory::next_entity() { return repository_.entity_allocator.create(); }
 
-    std::pair<Entity, NodeComponent*> ComponentFactory::create_entity(std::string node_name,
-                                                                      const glm::vec3& position,
-                                                                      const glm::quat& rotation,
-                                                                      const float& scale) {
+    std::pair<Entity, NodeComponent*> ComponentFactory::create_entity(
+        const std::string_view node_name, const glm::vec3& position, const glm::quat& rotation,
+        const float& scale) {
       const Entity new_entity = next_entity();
 
-      if (node_name.empty()) {
-        node_name = "entity_" + std::to_string(new_entity);
-      }
+      // unnamed nodes keep the empty name, the editor shows them by their entity
       const NodeComponent node = {
-          .name = node_name,
+          .name = repository_.names.intern(node_name),
       };
 
       create_transform_component(new_entity, position, rotation, scale);
       repository_.scene_graph.upsert(new_entity, node);
-
-      fmt::print("created entity {}\n", new_entity);
+      repository_.scene_hierarchy.insert(new_entity);
 
       return std::make_pair(new_entity, repository_.scene_graph.find_mutable(new_entity));
     }
@@ -99,16 +97,25 @@ namespace gestalt::application {
                                                                const glm::vec3& position,
                                                                const glm::quat& rotation,
                                                                const float& scale) const {
-      const auto transform = TransformComponent(position, rotation, scale);
-      transform.is_dirty = true;
-      repository_.transform_components.upsert(entity, transform);
+      repository_.transform_components.upsert(entity,
+                                              TransformComponent(position, rotation, scale));
+    }
+
+    void ComponentFactory::exclude_from_bounds(const Entity entity) const {
+      if (const auto node = repository_.scene_graph.find_mutable(entity); node != nullptr) {
+        node->contributes_to_bounds = false;
+        repository_.scene_graph.mark_changed(entity);
+        repository_.scene_hierarchy.invalidate_bounds(entity);
+      }
     }
 
     void ComponentFactory::add_mesh_component(const Entity entity,
                                               const size_t mesh_index) {
-      assert(entity != invalid_entity);
+      if (!expect_alive(entity)) {
+        return;
+      }
 
-      repository_.mesh_components.upsert(entity, MeshComponent{{true}, mesh_index});
+      repository_.mesh_components.upsert(entity, MeshComponent{{}, mesh_index});
     }
 
   void ComponentFactory::create_mesh(std::vector<MeshSurface> surfaces, const std::string& name) const {
@@ -143,44 +150,69 @@ namespace gestalt::application {
 
   void ComponentFactory::create_physics_component(const Entity entity, const BodyType body_type,
                                                   const BoxCollider& collider) const {
+      if (!expect_alive(entity)) {
+        return;
+      }
       repository_.physics_components.upsert(entity, PhysicsComponent(body_type, collider));
+      if (body_type == DYNAMIC) {
+        set_static(entity, false);
+      }
     }
 
   void ComponentFactory::create_physics_component(const Entity entity, const BodyType body_type,
                                                   const SphereCollider& collider) const {
+      if (!expect_alive(entity)) {
+        return;
+      }
       repository_.physics_components.upsert(entity, PhysicsComponent(body_type, collider));
+      if (body_type == DYNAMIC) {
+        set_static(entity, false);
+      }
     }
 
   void ComponentFactory::create_physics_component(const Entity entity, const BodyType body_type,
                                                   const CapsuleCollider& collider) const {
+      if (!expect_alive(entity)) {
+        return;
+      }
       repository_.physics_components.upsert(entity, PhysicsComponent(body_type, collider));
+      if (body_type == DYNAMIC) {
+        set_static(entity, false);
+      }
     }
 
   void ComponentFactory::create_animation_component(
         const Entity entity, const std::vector<Keyframe<glm::vec3>>& translation_keyframes,
         const std::vector<Keyframe<glm::quat>>& rotation_keyframes,
         const std::vector<Keyframe<glm::vec3>>& scale_keyframes) const {
+    if (!expect_alive(entity)) {
+      return;
+    }
     repository_.animation_components.upsert(
         entity, AnimationComponent(translation_keyframes, rotation_keyframes, scale_keyframes));
+    set_static(entity, false);
     }
 
     Entity ComponentFactory::create_directional_light(const glm::vec3& color,
                                                                const float intensity,
                                                                const glm::vec3& direction,
                                                       Entity entity) {
+      if (entity != invalid_entity && !expect_alive(entity)) {
+        return invalid_entity;
+      }
       if (entity == invalid_entity) {
         const auto number_of_lights = repository_.directional_light_components.size();
         auto [new_entity, node]
             = create_entity("directional_light_" + std::to_string(number_of_lights + 1));
         entity = new_entity;
         link_entity_to_parent(entity, root_entity);
-        auto transform = repository_.transform_components.find(entity);
-        event_bus_.emit<MoveEntityEvent>(
-            MoveEntityEvent{entity, transform->position(), orientation_from_direction(direction),transform->scale_uniform()
-        });
+        event_bus_.emit<TransformEntityEvent>(
+            TransformEntityEvent::rotate(entity, orientation_from_direction(direction)));
       }
 
 
+      exclude_from_bounds(entity);
+
       const uint32 matrix_id
           = repository_.light_view_projections.add({glm::mat4(1.0), glm::mat4(1.0)});
       const DirectionalLightComponent light(color, intensity, matrix_id);
@@ -195,15 +227,20 @@ namespace gestalt::application {
                                                 const glm::vec3& position, const float32 range,
                                                 const float32 inner_cone_radians,
                                                 const float32 outer_cone_radians, Entity entity) {
+      if (entity != invalid_entity && !expect_alive(entity)) {
+        return invalid_entity;
+      }
       if (entity == invalid_entity) {
         const auto number_of_lights = repository_.spot_light_components.size();
         auto [new_entity, node]
             = create_entity("spot_light_" + std::to_string(number_of_lights + 1));
         entity = new_entity;
           link_entity_to_parent(entity, root_entity);
-        event_bus_.emit<MoveEntityEvent>(
-            MoveEntityEvent{entity, position,orientation_from_direction(direction),1.f});
+        event_bus_.emit<TransformEntityEvent>(TransformEntityEvent::move(
+            entity, position, orientation_from_direction(direction), 1.f));
       }
+      exclude_from_bounds(entity);
+
       const uint32 matrix_id
           = repository_.light_view_projections.add({glm::mat4(1.0), glm::mat4(1.0)});
 
@@ -217,19 +254,21 @@ namespace gestalt::application {
     Entity ComponentFactory::create_point_light(const glm::vec3& color,
                                                          const float32 intensity,
                                                          const glm::vec3& position, const float32 range, Entity entity) {
+      if (entity != invalid_entity && !expect_alive(entity)) {
+        return invalid_entity;
+      }
       if (entity == invalid_entity) {
         const auto number_of_lights = repository_.point_light_components.size();
         auto [new_entity, node]
             = create_entity("point_light_" + std::to_string(number_of_lights + 1));
         entity = new_entity;
           link_entity_to_parent(entity, root_entity);
-        auto transform = repository_.transform_components.find(entity);
-          event_bus_.emit<MoveEntityEvent>(
-              MoveEntityEvent{entity,position,transform->rotation(), transform->scale_uniform()
-        });
+        event_bus_.emit<TransformEntityEvent>(TransformEntityEvent::translate(entity, position));
       }
 
 
+      exclude_from_bounds(entity);
+
       const uint32 matrix_id
           = repository_.light_view_projections.add({glm::mat4(1.0), glm::mat4(1.0)});
       for (int i = 0; i < 5; i++) {
@@ -245,10 +284,14 @@ namespace gestalt::application {
                                                  const glm::vec3& direction, const glm::vec3& up,
                                                  const Entity entity,
                                                  const PerspectiveProjectionComponent projection) const {
+      if (!expect_alive(entity)) {
+        return invalid_entity;
+      }
       const auto free_fly_component
         = FreeFlyCameraComponent(position, direction, up);
       repository_.free_fly_camera_components.upsert(entity, free_fly_component);
       repository_.perspective_projection_components.upsert(entity, projection);
+      exclude_from_bounds(entity);
 
       return entity;
   }
@@ -257,47 +300,67 @@ namespace gestalt::application {
                                                  const glm::vec3& direction, const glm::vec3& up,
                                                  const Entity entity,
                                                  const OrthographicProjectionComponent projection) const {
+      if (!expect_alive(entity)) {
+        return invalid_entity;
+      }
       const auto free_fly_component
         = FreeFlyCameraComponent(position, direction, up);
       repository_.free_fly_camera_components.upsert(entity, free_fly_component);
       repository_.orthographic_projection_components.upsert(entity, projection);
+      exclude_from_bounds(entity);
 
       return entity;
   }
 
   Entity ComponentFactory::add_animation_camera(const glm::vec3& position, const glm::quat& orientation, const Entity entity,
                                                 const PerspectiveProjectionComponent projection) const {
+    if (!expect_alive(entity)) {
+      return invalid_entity;
+    }
     const auto animation_component
         = AnimationCameraComponent(position, orientation);
     repository_.animation_camera_components.upsert(entity, animation_component);
     repository_.perspective_projection_components.upsert(entity, projection);
+    exclude_from_bounds(entity);
 
     return entity;
   }
 
   Entity ComponentFactory::add_animation_camera(const glm::vec3& position, const glm::quat& orientation, const Entity entity,
                                                 const OrthographicProjectionComponent projection) const {
+    if (!expect_alive(entity)) {
+      return invalid_entity;
+    }
     const auto animation_component
         = AnimationCameraComponent(position, orientation);
     repository_.animation_camera_components.upsert(entity, animation_component);
     repository_.orthographic_projection_components.upsert(entity, projection);
+    exclude_from_bounds(entity);
 
     return entity;
   }
 
   Entity ComponentFactory::add_orbit_camera(const glm::vec3& target, const Entity entity,
                                             const PerspectiveProjectionComponent projection) const {
+    if (!expect_alive(entity)) {
+      return invalid_entity;
+    }
     const auto orbit_component = OrbitCameraComponent(target);
     repository_.orbit_camera_components.upsert(entity, orbit_component);
     repository_.perspective_projection_components.upsert(entity, projection);
+    exclude_from_bounds(entity);
 
     return entity;
   }
   Entity ComponentFactory::add_orbit_camera(const glm::vec3& target, const Entity entity,
                                             const OrthographicProjectionComponent projection) const {
+    if (!expect_alive(entity)) {
+      return invalid_entity;
+    }
     const auto orbit_component = OrbitCameraComponent(target);
     repository_.orbit_camera_components.upsert(entity, orbit_component);
     repository_.orthographic_projection_components.upsert(entity, projection);
+    exclude_from_bounds(entity);
 
     return entity;
   }
@@ -305,10 +368,14 @@ namespace gestalt::application {
   Entity ComponentFactory::add_first_person_camera(
       const glm::vec3& position, const Entity entity,
       const PerspectiveProjectionComponent projection) const {
+    if (!expect_alive(entity)) {
+      return invalid_entity;
+    }
     const auto first_person_component
         = FirstPersonCameraComponent(position, glm::vec3(0.f, 1.f, 0.f));
     repository_.first_person_camera_components.upsert(entity, first_person_component);
     repository_.perspective_projection_components.upsert(entity, projection);
+    exclude_from_bounds(entity);
 
     return entity;
   }
@@ -316,10 +383,14 @@ namespace gestalt::application {
   Entity ComponentFactory::add_first_person_camera(
       const glm::vec3& position, const Entity entity,
       const OrthographicProjectionComponent projection) const {
+    if (!expect_alive(entity)) {
+      return invalid_entity;
+    }
     const auto first_person_component
         = FirstPersonCameraComponent(position, glm::vec3(0.f, 1.f, 0.f));
     repository_.first_person_camera_components.upsert(entity, first_person_component);
     repository_.orthographic_projection_components.upsert(entity, projection);
+    exclude_from_bounds(entity);
 
     return entity;
   }
@@ -331,11 +402,238 @@ namespace gestalt::application {
 
       const auto parent_node = repository_.scene_graph.find_mutable(parent);
       const auto child_node = repository_.scene_graph.find_mutable(child);
+      if (parent_node == nullptr || child_node == nullptr) {
+        return;
+      }
+
+      if (!repository_.scene_hierarchy.set_parent(child, parent)) {
+        fmt::println("cannot link entity {} to its descendant {}", child, parent);
+        return;
+      }
+
+      if (child_node->parent != invalid_entity) {
+        repository_.scene_hierarchy.invalidate_bounds(child_node->parent);  // its bounds shrink
+        detach_from_parent(*child_node);
+      }
+
+      // prepend, the order of siblings carries no meaning
+      child_node->parent = parent;
+      child_node->next_sibling = parent_node->first_child;
+      if (const auto next = repository_.scene_graph.find_mutable(parent_node->first_child);
+          next != nullptr) {
+        next->previous_sibling = child;
+      }
+      parent_node->first_child = child;
+      repository_.scene_graph.mark_changed(child);
+      repository_.transform_components.mark_changed(child);
+    }
+
+    void ComponentFactory::set_static(const Entity entity, const bool is_static) const {
+      const auto node = repository_.scene_graph.find(entity);
+      if (node == nullptr) {
+        return;
+      }
+      if (is_static && node->parent != invalid_entity && node->parent != root_entity
+          && !repository_.static_components.contains(node->parent)) {
+        fmt::println("entity {} cannot be static below the movable entity {}", entity,
+                     node->parent);
+        return;
+      }
+
+      // the whole subtree follows, so a static entity never ends up below a movable one
+      std::vector<Entity> subtree{entity};
+      while (!subtree.empty()) {
+        const Entity current = subtree.back();
+        subtree.pop_back();
+        if (repository_.static_components.contains(current) != is_static) {
+          repository_.static_components.set(current, is_static);
+          repository_.transform_components.mark_changed(current);  // moves it to the other BVH
+        }
+        for (Entity child = repository_.scene_graph.find(current)->first_child;
+             child != invalid_entity; child = repository_.scene_graph.find(child)->next_sibling) {
+          subtree.push_back(child);
+        }
+      }
+    }
+
+    void ComponentFactory::detach_from_parent(NodeComponent& node) const {
+      if (const auto previous = repository_.scene_graph.find_mutable(node.previous_sibling);
+          previous != nullptr) {
+        previous->next_sibling = node.next_sibling;
+      } else if (const auto parent = repository_.scene_graph.find_mutable(node.parent);
+                 parent != nullptr) {
+        parent->first_child = node.next_sibling;
+      }
+      if (const auto next = repository_.scene_graph.find_mutable(node.next_sibling);
+          next != nullptr) {
+        next->previous_sibling = node.previous_sibling;
+      }
+      node.parent = invalid_entity;
+      node.next_sibling = invalid_entity;
+      node.previous_sibling = invalid_entity;
+    }
+
+    std::vector<Entity> ComponentFactory::instantiate(const Entity prefab, const size_t count,
+                                                      const Entity parent) {
+      auto& scene_graph = repository_.scene_graph;
+      std::vector<Entity> roots;
+      if (count == 0 || scene_graph.find(prefab) == nullptr) {
+        return roots;
+      }
+
+      // the subtree breadth-first, so every parent is created before its children
+      std::vector<Entity> sources{prefab};
+      std::unordered_map<Entity, uint32> source_index{{prefab, 0}};
+      for (size_t i = 0; i < sources.size(); ++i) {
+        for (Entity child = scene_graph.find(sources[i])->first_child; child != invalid_entity;
+             child = scene_graph.find(child)->next_sibling) {
+          source_index.emplace(child, static_cast<uint32>(sources.size()));
+          sources.push_back(child);
+        }
+      }
+
+      // copy the rows up front, the storages grow while the instances are written
+      constexpr uint32 kNone = std::numeric_limits<uint32>::max();
+      const auto index_of = [&](const Entity entity) {
+        return entity == invalid_entity ? kNone : source_index.at(entity);
+      };
+      struct Row {
+        NodeComponent node;
+        TransformComponent transform;
+        std::optional<MeshComponent> mesh;
+        std::optional<AnimationComponent> animation;
+        bool hidden;
+        bool is_static;
+        uint32 parent, first_child, next_sibling, previous_sibling;
+      };
+      // a static copy below a movable parent would break the static subtree rule of set_static
+      const bool keep_static = parent == invalid_entity || parent == root_entity
+                               || repository_.static_components.contains(parent);
+      std::vector<Row> rows;
+      rows.reserve(sources.size());
+      for (size_t i = 0; i < sources.size(); ++i) {
+        const Entity source = sources[i];
+        const NodeComponent& node = *scene_graph.find(source);
+        const auto transform = repository_.transform_components.find(source);
+        const auto mesh = repository_.mesh_components.find(source);
+        const auto animation = repository_.animation_components.find(source);
+        // the prefab root is unlinked from its siblings and placed below parent afterwards
+        rows.push_back({
+            .node = node,
+            .transform = transform != nullptr ? *transform : TransformComponent(),
+            .mesh = mesh != nullptr ? std::optional(*mesh) : std::nullopt,
+            .animation = animation != nullptr ? std::optional(*animation) : std::nullopt,
+            .hidden = repository_.hidden_components.contains(source),
+            .is_static = keep_static && repository_.static_components.contains(source),
+            .parent = i == 0 ? kNone : index_of(node.parent),
+            .first_child = index_of(node.first_child),
+            .next_sibling = i == 0 ? kNone : index_of(node.next_sibling),
+            .previous_sibling = i == 0 ? kNone : index_of(node.previous_sibling),
+        });
+      }
+
+      const bool has_parent = parent != invalid_entity && scene_graph.contains(parent)
+                              && repository_.scene_hierarchy.contains(parent);
+      std::vector<Entity> instance(sources.size());
+      const auto remap
+          = [&](const uint32 index) { return index == kNone ? invalid_entity : instance[index]; };
+      roots.reserve(count);
+      for (size_t n = 0; n < count; ++n) {
+        for (Entity& entity : instance) {
+          entity = next_entity();
+        }
+
+        for (size_t i = 0; i < rows.size(); ++i) {
+          const Row& row = rows[i];
+          const Entity entity = instance[i];
+
+          NodeComponent node = row.node;
+          node.parent = remap(row.parent);
+          node.first_child = remap(row.first_child);
+          node.next_sibling = remap(row.next_sibling);
+          node.previous_sibling = remap(row.previous_sibling);
+          node.bounds.is_dirty = true;
+          // the root is new, so it is linked below parent directly instead of being moved there;
+          // prepended, the order of siblings carries no meaning
+          const bool link_root = i == 0 && has_parent;
+          if (link_root) {
+            node.parent = parent;
+            node.next_sibling = scene_graph.find(parent)->first_child;
+          }
+          scene_graph.upsert(entity, node);
+          if (link_root) {
+            if (const auto next = scene_graph.find_mutable(node.next_sibling); next != nullptr) {
+              next->previous_sibling = entity;
+            }
+            scene_graph.find_mutable(parent)->first_child = entity;
+          }
+          repository_.transform_components.upsert(entity, row.transform);
+          if (row.mesh.has_value()) {
+            repository_.mesh_components.upsert(entity, *row.mesh);
+          }
+          if (row.animation.has_value()) {
+            repository_.animation_components.upsert(entity, *row.animation);
+          }
+          if (row.hidden) {
+            repository_.hidden_components.add(entity);
+          }
+          if (row.is_static) {
+            repository_.static_components.add(entity);
+          }
+
+          if (node.parent == invalid_entity) {
+            repository_.scene_hierarchy.insert(entity);
+          } else {
+            repository_.scene_hierarchy.insert(entity, node.parent);
+          }
+        }
+
+        roots.push_back(instance[0]);
+      }
+      return roots;
+    }
+
+    void ComponentFactory::destroy_entity(const Entity entity) {
+      if (entity == root_entity || !is_alive(entity)) {
+        return;
+      }
+
+      if (const auto node = repository_.scene_graph.find_mutable(entity); node != nullptr) {
+        if (node->parent != invalid_entity) {
+          repository_.scene_hierarchy.invalidate_bounds(node->parent);  // parent bounds shrink
+          detach_from_parent(*node);
+        }
+        for (Entity child = node->first_child; child != invalid_entity;) {
+          const auto child_node = repository_.scene_graph.find_mutable(child);
+          if (child_node == nullptr) {
+            break;
+          }
+          const Entity orphan = child;
+          child = child_node->next_sibling;
+          child_node->parent = invalid_entity;
+          child_node->next_sibling = invalid_entity;
+          child_node->previous_sibling = invalid_entity;
+          repository_.scene_graph.mark_changed(orphan);  // no longer hidden with its parent
+        }
+      }
+
+      repository_.scene_hierarchy.remove(entity);
+      repository_.scene_bvh.remove(entity);
+      repository_.static_bvh.remove(entity);
+      repository_.remove_components(entity);
+      repository_.entity_allocator.destroy(entity);
+    }
+
+    bool ComponentFactory::is_alive(const Entity entity) const {
+      return repository_.entity_allocator.is_alive(entity);
+    }
 
-      if (parent_node != nullptr && child_node != nullptr) {
-        parent_node->children.push_back(child);
-        child_node->parent = parent;
+    bool ComponentFactory::expect_alive(const Entity entity) const {
+      if (is_alive(entity)) {
+        return true;
       }
+      fmt::println("entity {} was destroyed, its components are not written", entity);
+      return false;
     }
 
 }  // namespace gestalt
\ No newline at end of file
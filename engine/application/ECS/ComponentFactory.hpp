@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <glm/fwd.hpp>
 
@@ -31,12 +32,14 @@ namespace gestalt::application {
       Repository& repository_;
       EventBus& event_bus_;
 
-      Entity next_entity_id_{0};
-
       Entity next_entity();
       void create_transform_component(unsigned entity, const glm::vec3& position = glm::vec3(0.f),
                                       const glm::quat& rotation = glm::quat(1.f, 0.f, 0.f, 0.f),
                                       const float& scale = 1.f) const;
+      void exclude_from_bounds(Entity entity) const;
+      void detach_from_parent(NodeComponent& node) const;
+      // storages cannot tell the dead handle of an unused slot from a live one
+      [[nodiscard]] bool expect_alive(Entity entity) const;
 
     public:
       explicit ComponentFactory(Repository& repository, EventBus& event_bus);
@@ -48,7 +51,7 @@ namespace gestalt::application {
       ComponentFactory(ComponentFactory&&) = delete;
       ComponentFactory& operator=(ComponentFactory&&) = delete;
 
-      std::pair<Entity, NodeComponent*> create_entity(std::string node_name = "",
+      std::pair<Entity, NodeComponent*> create_entity(std::string_view node_name = {},
                                                       const glm::vec3& position = glm::vec3(0.f),
                                                       const glm::quat& rotation
                                                       = glm::quat(1.f, 0.f, 0.f, 0.f),
@@ -110,7 +113,36 @@ namespace gestalt::application {
       Entity add_first_person_camera(const glm::vec3& position, Entity entity,
                                      OrthographicProjectionComponent projection) const;
 
+      /**
+       * @brief Moves child and its subtree below parent. O(1) on the NodeComponent links, O(size of
+       * the subtree) in the SceneHierarchy, which moves every node of the subtree to its new depth.
+       */
       void link_entity_to_parent(Entity child, Entity parent);
+
+      /**
+       * @brief Marks the entity and its subtree static or movable. Static entities are expected to
+       * keep their world transform, systems may cache what they derive from it. An entity can only
+       * become static if its parent is static or the root. Animations and dynamic bodies make
+       * their entity movable.
+       */
+      void set_static(Entity entity, bool is_static) const;
+
+      /**
+       * @brief Creates count copies of the subtree below prefab and links each copy's root to
+       * parent. Node, transform, mesh, animation, hidden and static rows are copied with their
+       * entity links remapped, so the copies share meshes and materials with the prefab. Copies
+       * below a movable parent are movable. Lights, cameras and physics bodies own GPU or
+       * simulation resources and are not copied.
+       * @return the root entity of every copy
+       */
+      std::vector<Entity> instantiate(Entity prefab, size_t count, Entity parent = root_entity);
+
+      /**
+       * @brief Unlinks the entity from its parent, removes all of its components and recycles its
+       * handle. Children are not touched; see EntityComponentSystem::destroy_entity for subtrees.
+       */
+      void destroy_entity(Entity entity);
+      [[nodiscard]] bool is_alive(Entity entity) const;
     };
 
 }  // namespace gestalt::application
\ No newline at end of file
@@ -18,7 +18,8 @@ namespace gestalt::application {
 
   EntityComponentSystem::EntityComponentSystem(IGpu& gpu, IResourceAllocator& resource_allocator,
                                                Repository& repository,
-                                               EventBus& event_bus, FrameProvider& frame)
+                                               EventBus& event_bus, FrameProvider& frame,
+                                               JobSystem& job_system)
       : gpu_(gpu),
         repository_(repository),
         event_bus_(event_bus),
@@ -31,8 +32,12 @@ namespace gestalt::application {
         animation_system_(repository_, event_bus_),
         mesh_system_(gpu_, resource_allocator, repository_, frame),
         audio_system_(),
-        physics_system_(gpu_, resource_allocator, repository_, frame, event_bus_),
-        raytracing_system_(gpu_, resource_allocator, repository_, frame) {
+        physics_system_(gpu_, resource_allocator, repository_, frame, event_bus_, job_system),
+        raytracing_system_(gpu_, resource_allocator, repository_, frame),
+        scheduler_(repository_, event_bus_, job_system) {
+    scheduler_.set_validation_enabled(validateSystemAccess());
+    register_systems();
+
     if (const std::string initial_scene = getInitialScene(); !initial_scene.empty()) {
       request_scene(std::filesystem::current_path() / "../../assets" / initial_scene);
     }
@@ -52,6 +57,67 @@ namespace gestalt::application {
 
   EntityComponentSystem::~EntityComponentSystem() = default;
 
+  void EntityComponentSystem::register_systems() {
+    using enum SystemResource;
+
+    // conflicting systems run in registration order; world transforms are refreshed before
+    // anything reads them
+    scheduler_.add_system("material", SystemAccess{}.write(kMaterials).write(kGpuSubmission),
+                          [this](const SystemContext&) { material_system_.update(); });
+    scheduler_.add_system("transform",
+                          SystemAccess{}
+                              .read(kTransformComponents)
+                              .read(kMeshComponents)
+                              .read(kMeshData)
+                              .write(kSceneGraph)
+                              .write(kSceneBvh),
+                          [this](const SystemContext& context) {
+                            transform_system_.update(context);
+                          });
+    scheduler_.add_system("camera",
+                          SystemAccess{}
+                              .read(kTransformComponents)
+                              .write(kCameraComponents)
+                              .write(kPerFrameData)
+                              .write(kGpuSubmission)
+                              .write(kEventBus),
+                          [this](const SystemContext& context) {
+                            camera_system_.update(context, delta_time_, *movement_, aspect_);
+                          });
+    scheduler_.add_system("light",
+                          SystemAccess{}
+                              .read(kSceneGraph)
+                              .read(kPerFrameData)
+                              .write(kLightComponents)
+                              .write(kLightData),
+                          [this](const SystemContext& context) { light_system_.update(context); });
+    scheduler_.add_system("mesh",
+                          SystemAccess{}
+                              .read(kSceneGraph)
+                              .read(kMeshComponents)
+                              .read(kMaterials)
+                              .write(kMeshData)
+                              .write(kGpuSubmission),
+                          [this](const SystemContext& context) { mesh_system_.update(context); });
+    scheduler_.add_system("animation",
+                          SystemAccess{}.write(kAnimationComponents).write(kEventBus),
+                          [this](const SystemContext& context) {
+                            animation_system_.update(context, delta_time_);
+                          });
+    scheduler_.add_system("audio", SystemAccess{},
+                          [this](const SystemContext&) { audio_system_.update(); });
+    scheduler_.add_system("raytracing",
+                          SystemAccess{}
+                              .read(kSceneGraph)
+                              .read(kMeshComponents)
+                              .read(kMeshData)
+                              .write(kAccelerationStructures)
+                              .write(kGpuSubmission),
+                          [this](const SystemContext& context) {
+                            raytracing_system_.update(context);
+                          });
+  }
+
   void EntityComponentSystem::set_active_camera(const Entity camera) {
     camera_system_.set_active_camera(camera);
   }
@@ -61,34 +127,58 @@ namespace gestalt::application {
   }
 
   void EntityComponentSystem::add_to_root(Entity entity, NodeComponent& node) {
-    if (entity != invalid_entity) {
+    if (entity == invalid_entity) {
       throw std::runtime_error("Entity has invalid id");
     }
-    repository_.scene_graph.find_mutable(get_root_entity())->children.push_back(entity);
-    node.parent = get_root_entity();
+    component_factory_.link_entity_to_parent(entity, get_root_entity());
+  }
+
+  void EntityComponentSystem::destroy_entity(const Entity entity) {
+    if (entity == root_entity_ || !component_factory_.is_alive(entity)) {
+      return;
+    }
+
+    // children unlink themselves from this node when destroyed
+    for (auto node = repository_.scene_graph.find(entity);
+         node != nullptr && node->first_child != invalid_entity;
+         node = repository_.scene_graph.find(entity)) {
+      destroy_entity(node->first_child);
+    }
+
+    physics_system_.release_body(entity);
+    component_factory_.destroy_entity(entity);
   }
 
   void EntityComponentSystem::update_scene(const float delta_time, const UserInput& movement,
                                            const float aspect) {
+    repository_.advance_change_windows();
+
     if (!scene_path_.empty()) {
       asset_loader_.load_scene_from_gltf(scene_path_);
       scene_path_.clear();
     }
 
-    material_system_.update();
-    camera_system_.update(delta_time, movement, aspect);
-    light_system_.update();
-    transform_system_.update();
-    mesh_system_.update();
-    animation_system_.update(delta_time);
-    audio_system_.update();
-    raytracing_system_.update();
+    // sync point: changes recorded since the last frame, e.g. by import jobs
+    play_back_commands();
+
+    delta_time_ = delta_time;
+    movement_ = &movement;
+    aspect_ = aspect;
+    scheduler_.run();
+
+    // sync point: changes recorded by the systems of this frame
+    play_back_commands();
 
     event_bus_.poll();
 
     scene_path_.clear();
   }
 
+  void EntityComponentSystem::play_back_commands() {
+    command_queue_.play_back(repository_, component_factory_,
+                             [this](const Entity entity) { destroy_entity(entity); });
+  }
+
   void EntityComponentSystem::request_scene(const std::filesystem::path& file_path) {
     scene_path_ = file_path;
   }
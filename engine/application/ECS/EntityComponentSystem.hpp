@@ -5,12 +5,14 @@
 #include "AnimationSystem.hpp"
 #include "AudioSystem.hpp"
 #include "CameraSystem.hpp"
+#include "CommandBuffer.hpp"
 #include "ComponentFactory.hpp"
 #include "LightSystem.hpp"
 #include "MaterialSystem.hpp"
 #include "MeshSystem.hpp"
 #include "PhysicSystem.hpp"
 #include "RayTracingSystem.hpp"
+#include "SystemScheduler.hpp"
 #include "TransformSystem.hpp"
 #include "common.hpp"
 #include "Resource Loading/AssetLoader.hpp"
@@ -21,6 +23,7 @@ namespace gestalt::foundation {
   struct UserInput;
   class IDescriptorLayoutBuilder;
   class IGpu;
+  class JobSystem;
 }
 
 namespace gestalt::application {
@@ -34,6 +37,7 @@ namespace gestalt::application {
       EventBus& event_bus_;
 
       ComponentFactory component_factory_;
+      CommandQueue command_queue_;
       AssetLoader asset_loader_;
 
       MaterialSystem material_system_;
@@ -46,13 +50,21 @@ namespace gestalt::application {
       PhysicSystem physics_system_;
       RayTracingSystem raytracing_system_;
 
+      SystemScheduler scheduler_;
+      float delta_time_ = 0.f;
+      const UserInput* movement_ = nullptr;
+      float aspect_ = 0.f;
+
+      void register_systems();
+      void play_back_commands();
+
       Entity root_entity_ = 0;
       std::filesystem::path scene_path_;
 
     public:
       EntityComponentSystem(IGpu& gpu, IResourceAllocator& resource_allocator,
                             Repository& repository, EventBus& event_bus,
-                 FrameProvider& frame);
+                 FrameProvider& frame, JobSystem& job_system);
       ~EntityComponentSystem();
 
       EntityComponentSystem(const EntityComponentSystem&) = delete;
@@ -65,8 +77,20 @@ namespace gestalt::application {
 
       void request_scene(const std::filesystem::path& file_path);
       [[nodiscard]] ComponentFactory& get_component_factory() { return component_factory_; }
+
+      /**
+       * @brief Structural changes recorded here from any thread are applied before the systems of
+       * the next update_scene run and once more after they ran.
+       */
+      [[nodiscard]] CommandQueue& get_command_queue() { return command_queue_; }
       [[nodiscard]] uint32 get_root_entity() const { return root_entity_; }
       void add_to_root(Entity entity, NodeComponent& node);
+
+      /**
+       * @brief Destroys the entity and its whole subtree, releasing physics bodies before the
+       * components are removed.
+       */
+      void destroy_entity(Entity entity);
       void set_active_camera(Entity camera);
       [[nodiscard]] Entity get_active_camera() const;
     };
@@ -11,6 +11,7 @@
 #include "Interface/IResourceAllocator.hpp"
 #include "Resources/GpuProjViewData.hpp"
 #include "Resources/GpuSpotLight.hpp"
+#include "SystemContext.hpp"
 
 namespace gestalt::application {
 
@@ -30,28 +31,28 @@ namespace gestalt::application {
       if (dir_light != nullptr) {
         dir_light->set_color(event.color);
         dir_light->set_intensity(event.intensity);
-        dir_light->is_dirty = true;
+        repository_.directional_light_components.mark_changed(event.entity);
         return;
       }
       auto point_light = repository_.point_light_components.find_mutable(event.entity);
       if (point_light != nullptr) {
         point_light->set_color(event.color);
         point_light->set_intensity(event.intensity);
-        point_light->is_dirty = true;
+        repository_.point_light_components.mark_changed(event.entity);
         return;
       }
       auto spot_light = repository_.spot_light_components.find_mutable(event.entity);
       if (spot_light != nullptr) {
         spot_light->set_color(event.color);
         spot_light->set_intensity(event.intensity);
-        spot_light->is_dirty = true;
+        repository_.spot_light_components.mark_changed(event.entity);
       }
     });
     event_bus_.subscribe<UpdatePointLightEvent>([this](const UpdatePointLightEvent& event) {
       auto point_light = repository_.point_light_components.find_mutable(event.entity);
       if (point_light != nullptr) {
         point_light->set_range(event.range);
-        point_light->is_dirty = true;
+        repository_.point_light_components.mark_changed(event.entity);
       }
     });
     event_bus_.subscribe<UpdateSpotLightEvent>([this](const UpdateSpotLightEvent& event) {
@@ -60,7 +61,7 @@ namespace gestalt::application {
         spot_light->set_range(event.range);
         spot_light->set_inner_cone_cos(event.inner_cos);
         spot_light->set_outer_cone_cos(event.outer_cos);
-        spot_light->is_dirty = true;
+        repository_.spot_light_components.mark_changed(event.entity);
       }
     });
     create_buffers();
@@ -228,14 +229,21 @@ namespace gestalt::application {
     return glm::orthoRH_ZO(left, right, bottom, top, nearZ, farZ);
   }
 
-  void LightSystem::update() {
+  void LightSystem::update(const SystemContext& context) {
     repository_.light_view_projections.clear();
     repository_.directional_lights.clear();
     repository_.point_lights.clear();
     repository_.spot_lights.clear();
 
-    for (auto [entity, light_component] : repository_.directional_light_components.snapshot()) {
-        const auto& rotation = repository_.transform_components.find(entity)->rotation();
+    const auto& hierarchy = repository_.scene_hierarchy;
+
+    context.write<DirectionalLightComponent>().for_each(
+        [&](const Entity entity, DirectionalLightComponent& light_component) {
+        const auto transform = hierarchy.world_transform(entity);
+        if (transform == nullptr) {
+          return;
+        }
+        const auto& rotation = transform->rotation;
         glm::vec3 direction = -glm::normalize(rotation * glm::vec3(0, 0, -1.f));
 
         light_component.set_light_view_projection(repository_.light_view_projections.size());
@@ -254,10 +262,14 @@ namespace gestalt::application {
         dir_light.viewProj = light_component.light_view_projection();
         repository_.directional_lights.add(dir_light);
 
-        light_component.is_dirty = false;
-    }
-    for (auto [entity, light_component] : repository_.point_light_components.snapshot()) {
-        const auto& position = repository_.transform_components.find(entity)->position();
+    });
+    context.write<PointLightComponent>().for_each(
+        [&](const Entity entity, PointLightComponent& light_component) {
+        const auto transform = hierarchy.world_transform(entity);
+        if (transform == nullptr) {
+          return;
+        }
+        const auto& position = transform->position;
 
         // TODO Calculate the 6 view matrices for the light
 
@@ -268,11 +280,15 @@ namespace gestalt::application {
         point_light.range = light_component.range();
         repository_.point_lights.add(point_light);
 
-        light_component.is_dirty = false;
-    }
-    for (auto [entity, light_component] : repository_.spot_light_components.snapshot()) {
-        const auto& position = repository_.transform_components.find(entity)->position();
-        const auto& rotation = repository_.transform_components.find(entity)->rotation();
+    });
+    context.write<SpotLightComponent>().for_each(
+        [&](const Entity entity, SpotLightComponent& light_component) {
+        const auto transform = hierarchy.world_transform(entity);
+        if (transform == nullptr) {
+          return;
+        }
+        const auto& position = transform->position;
+        const auto& rotation = transform->rotation;
 
         GpuSpotLight spot_light = {};
         spot_light.color = light_component.color();
@@ -283,8 +299,7 @@ namespace gestalt::application {
         spot_light.inner_cone_angle = light_component.inner_cone_cos();
         spot_light.outer_cone_angle = light_component.outer_cone_cos();
         repository_.spot_lights.add(spot_light);
-        light_component.is_dirty = false;
-    }
+    });
 
     auto& light_data = repository_.light_buffers;
 
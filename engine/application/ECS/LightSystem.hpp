@@ -9,6 +9,7 @@ namespace gestalt::foundation {
 
 namespace gestalt::application {
   class EventBus;
+  class SystemContext;
 
   class LightSystem final {
       IGpu& gpu_;
@@ -38,7 +39,7 @@ namespace gestalt::application {
       LightSystem(LightSystem&&) = delete;
       LightSystem& operator=(LightSystem&&) = delete;
 
-      void update();
+      void update(const SystemContext& context);
     };
 
 }  // namespace gestalt
\ No newline at end of file
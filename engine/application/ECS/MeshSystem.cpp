@@ -1,6 +1,7 @@
 ﻿#include "MeshSystem.hpp"
 
-#include <numeric>
+#include <algorithm>
+#include <cstring>
 #include <ranges>
 #include <span>
 
@@ -8,6 +9,7 @@
 #include <fmt/core.h>
 
 #include "FrameProvider.hpp"
+#include "SystemContext.hpp"
 #include "Interface/IGpu.hpp"
 #include "Interface/IResourceAllocator.hpp"
 #include "Mesh/MeshSurface.hpp"
@@ -227,7 +229,7 @@ namespace gestalt::application {
                        0, VMA_MEMORY_USAGE_GPU_ONLY, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
   }
 
-  void MeshSystem::update() {
+  void MeshSystem::update(const SystemContext& context) {
     if (repository_.meshes.size() != meshes_) {
       meshes_ = repository_.meshes.size();
 
@@ -236,74 +238,251 @@ namespace gestalt::application {
       upload_mesh();
     }
 
-    const auto root_transform = TransformComponent();
+    const auto& mesh_components = context.read<MeshComponent>();
+    const auto& scene_graph = context.read<NodeComponent>();
+    const auto& hidden_components = context.read<HiddenComponent>();
 
-    repository_.mesh_draws_.clear();
-    traverse_scene(0, root_transform);
+    if (mesh_components.changed_since(last_mesh_version_)) {
+      release_removed_draws(mesh_components);
+      assign_draws(mesh_components);
+    }
+    update_visibility(mesh_components, scene_graph, hidden_components);
+    last_mesh_version_ = mesh_components.version();
+    last_node_version_ = scene_graph.version();
+    last_hidden_version_ = hidden_components.version();
+
+    const auto& hierarchy = repository_.scene_hierarchy;
+    for (const Entity entity : hierarchy.moved()) {
+      const DrawRange* range = find_draw_range(entity);
+      const auto world_transform = hierarchy.world_transform(entity);
+      if (range != nullptr && range->visible && world_transform != nullptr) {
+        write_draws(mesh_components, *range, *world_transform);
+      }
+    }
 
-    if (repository_.mesh_draws_.empty()) {
-      return;
+    upload_dirty_draws();
+  }
+
+  MeshSystem::DrawRange* MeshSystem::find_draw_range(const Entity entity) {
+    const uint32 index = entity_index(entity);
+    if (index >= draw_ranges_.size() || draw_ranges_[index].entity != entity) {
+      return nullptr;
     }
+    return &draw_ranges_[index];
+  }
 
-    const size_t mesh_draw_buffer_size = repository_.mesh_draws_.size() * sizeof(MeshDraw);
+  uint32 MeshSystem::allocate_draws(const uint32 count) {
+    for (auto it = free_draws_.begin(); it != free_draws_.end(); ++it) {
+      if (it->second < count) {
+        continue;
+      }
+      const uint32 first = it->first;
+      it->first += count;
+      it->second -= count;
+      if (it->second == 0) {
+        free_draws_.erase(it);
+      }
+      return first;
+    }
 
-    const auto& mesh_buffers = repository_.mesh_buffers;
+    // new slots are value-initialized and therefore have no meshlets until they are written
+    auto& mesh_draws = repository_.mesh_draws_;
+    const auto first = static_cast<uint32>(mesh_draws.size());
+    mesh_draws.resize(mesh_draws.size() + count);
+    dirty_draws_.emplace_back(first, count);
 
+    const size_t mesh_draw_buffer_size = mesh_draws.size() * sizeof(MeshDraw);
     if (kMaxMeshDrawBufferSize < mesh_draw_buffer_size) {
       fmt::println("mesh_draw_buffer size needs to be increased by {}",
-                   mesh_draw_buffer_size - mesh_buffers->mesh_draw_buffer->get_size());
+                   mesh_draw_buffer_size - kMaxMeshDrawBufferSize);
     }
+    return first;
+  }
 
-    mesh_buffers->mesh_draw_buffer->copy_to_mapped(
-        gpu_.getAllocator(), repository_.mesh_draws_.data(),
-                                                   mesh_draw_buffer_size);
+  void MeshSystem::release_draws(DrawRange& range) {
+    if (range.count == 0) {
+      return;
+    }
+    hide_draws(range);
+
+    // the free list is sorted by slot and adjacent ranges are merged
+    auto it = std::ranges::lower_bound(free_draws_, std::pair{range.first, 0u});
+    it = free_draws_.insert(it, {range.first, range.count});
+    if (const auto next = std::next(it);
+        next != free_draws_.end() && it->first + it->second == next->first) {
+      it->second += next->second;
+      free_draws_.erase(next);
+    }
+    if (it != free_draws_.begin()) {
+      if (const auto previous = std::prev(it); previous->first + previous->second == it->first) {
+        previous->second += it->second;
+        free_draws_.erase(it);
+      }
+    }
 
+    range.count = 0;
+    range.visible = false;
   }
 
-  void MeshSystem::traverse_scene(const Entity entity, const TransformComponent& parent_transform) {
-    const auto& node = repository_.scene_graph.find(entity);
-    if (!node->visible) {
+  void MeshSystem::write_draws(const StorageOf<MeshComponent>& mesh_components,
+                               const DrawRange& range,
+                               const WorldTransformComponent& world_transform) {
+    const auto mesh_component = mesh_components.find(range.entity);
+    if (mesh_component == nullptr) {
       return;
     }
 
-    const auto local_transform = repository_.transform_components.find(entity);
-
-    TransformComponent world_transform = parent_transform * *local_transform;
-
-    const auto mesh_component = repository_.mesh_components.find(entity);
-    if (mesh_component) {
-      const auto& mesh = repository_.meshes.get(mesh_component->mesh);
-
-      for (const auto surface : mesh.surfaces) {
-        const auto& material = repository_.materials.get(surface.material);
-
-        MeshDraw draw{
-            .position = world_transform.position(),
-            .scale = world_transform.scale().x,
-            .orientation = world_transform.rotation(),
-            .center = glm::vec3(surface.local_bounds.center),
-            .radius = surface.local_bounds.radius,
-            .meshlet_offset = surface.meshlet_offset,
-            .meshlet_count = surface.meshlet_count,
-            .vertex_count = surface.vertex_count,
-            .index_count = surface.index_count,
-            .first_index = surface.first_index,
-            .vertex_offset = surface.vertex_offset,
-            .materialIndex = static_cast<uint32>(surface.material),
-        };
-
-        repository_.mesh_draws_.push_back(draw);
-
-        if (material.config.transparent) {
-          // mesh_task_commands_.push_back(task);
-        } else {
+    const auto& mesh = repository_.meshes.get(mesh_component->mesh);
+    for (uint32 i = 0; i < range.count; ++i) {
+      const auto& surface = mesh.surfaces[i];
+      repository_.mesh_draws_[range.first + i] = MeshDraw{
+          .position = world_transform.position,
+          .scale = world_transform.scale,
+          .orientation = world_transform.rotation,
+          .center = glm::vec3(surface.local_bounds.center),
+          .radius = surface.local_bounds.radius,
+          .meshlet_offset = surface.meshlet_offset,
+          .meshlet_count = surface.meshlet_count,
+          .vertex_count = surface.vertex_count,
+          .index_count = surface.index_count,
+          .first_index = surface.first_index,
+          .vertex_offset = surface.vertex_offset,
+          .materialIndex = static_cast<uint32>(surface.material),
+      };
+    }
+    dirty_draws_.emplace_back(range.first, range.count);
+  }
+
+  void MeshSystem::hide_draws(const DrawRange& range) {
+    // the culling pass emits no task groups for a draw without meshlets
+    std::fill_n(repository_.mesh_draws_.begin() + range.first, range.count, MeshDraw{});
+    dirty_draws_.emplace_back(range.first, range.count);
+  }
+
+  void MeshSystem::release_removed_draws(const StorageOf<MeshComponent>& mesh_components) {
+    for (DrawRange& range : draw_ranges_) {
+      if (range.entity != invalid_entity && !mesh_components.contains(range.entity)) {
+        release_draws(range);
+        range = {};
+      }
+    }
+  }
+
+  void MeshSystem::assign_draws(const StorageOf<MeshComponent>& mesh_components) {
+    mesh_components.for_each_changed_since(
+        last_mesh_version_, [this](const Entity entity, const MeshComponent& mesh_component) {
+          const uint32 index = entity_index(entity);
+          if (index >= draw_ranges_.size()) {
+            draw_ranges_.resize(index + 1);
+          }
+
+          // the mesh may have been swapped, so the surfaces get fresh slots
+          DrawRange& range = draw_ranges_[index];
+          release_draws(range);
+          range.entity = entity;
+          range.count = static_cast<uint32>(
+              repository_.meshes.get(mesh_component.mesh).surfaces.size());
+          range.first = allocate_draws(range.count);
+        });
+  }
+
+  void MeshSystem::update_visibility(const StorageOf<MeshComponent>& mesh_components,
+                                     const StorageOf<NodeComponent>& scene_graph,
+                                     const StorageOf<HiddenComponent>& hidden_components) {
+    auto& hierarchy = repository_.scene_hierarchy;
+
+    // nodes that were created, relinked, tagged or untagged, or got a mesh since the last update
+    const uint64 pass = ++visibility_pass_;
+    visibility_roots_.clear();
+    const auto add_root = [&](const Entity entity, const auto&...) {
+      if (!hierarchy.contains(entity)) {
+        return;
+      }
+      const uint32 index = entity_index(entity);
+      if (index >= root_passes_.size()) {
+        root_passes_.resize(index + 1, 0);
+      }
+      if (root_passes_[index] != pass) {
+        root_passes_[index] = pass;
+        visibility_roots_.push_back(entity);
+      }
+    };
+    mesh_components.for_each_changed_since(last_mesh_version_, add_root);
+    scene_graph.for_each_changed_since(last_node_version_, add_root);
+    hidden_components.for_each_changed_since(last_hidden_version_, add_root);
+
+    for (const Entity root : visibility_roots_) {
+      // a root below another root is walked with that one
+      bool covered = false;
+      bool ancestors_visible = true;
+      for (Entity ancestor = hierarchy.parent(root); ancestor != invalid_entity;
+           ancestor = hierarchy.parent(ancestor)) {
+        if (root_passes_[entity_index(ancestor)] == pass) {
+          covered = true;
+          break;
         }
+        ancestors_visible &= !hidden_components.contains(ancestor);
       }
+      if (covered) {
+        continue;
+      }
+
+      // a hidden node hides its whole subtree
+      hierarchy.traverse_subtree(
+          root, ancestors_visible,
+          [&](const Entity entity, const WorldTransformComponent& world_transform,
+              const bool parent_visible) {
+            const bool visible = parent_visible && !hidden_components.contains(entity);
+            if (DrawRange* range = find_draw_range(entity);
+                range != nullptr && range->count > 0 && range->visible != visible) {
+              range->visible = visible;
+              if (visible) {
+                write_draws(mesh_components, *range, world_transform);
+              } else {
+                hide_draws(*range);
+              }
+            }
+            return visible;
+          });
     }
+  }
 
-    for (const auto& childEntity : node->children) {
-      traverse_scene(childEntity, world_transform);
+  void MeshSystem::upload_dirty_draws() {
+    if (dirty_draws_.empty()) {
+      return;
     }
+
+    // ranges closer than this are uploaded together, one copy is cheaper than many small ones
+    constexpr uint32 kMergeDistance = 16;
+    constexpr uint32 kCapacity = getMaxMeshes();
+
+    std::ranges::sort(dirty_draws_);
+
+    const auto& mesh_draw_buffer = repository_.mesh_buffers->mesh_draw_buffer;
+    void* data;
+    VK_CHECK(vmaMapMemory(gpu_.getAllocator(), mesh_draw_buffer->get_allocation(), &data));
+
+    const auto copy = [&](const uint32 first, uint32 end) {
+      end = std::min(end, kCapacity);
+      if (first < end) {
+        memcpy(static_cast<MeshDraw*>(data) + first, repository_.mesh_draws_.data() + first,
+               (end - first) * sizeof(MeshDraw));
+      }
+    };
+
+    uint32 first = dirty_draws_.front().first;
+    uint32 end = first + dirty_draws_.front().second;
+    for (const auto& [dirty_first, dirty_count] : dirty_draws_) {
+      if (dirty_first > end + kMergeDistance) {
+        copy(first, end);
+        first = dirty_first;
+      }
+      end = std::max(end, dirty_first + dirty_count);
+    }
+    copy(first, end);
+
+    vmaUnmapMemory(gpu_.getAllocator(), mesh_draw_buffer->get_allocation());
+    dirty_draws_.clear();
   }
 
   MeshSystem::~MeshSystem() {
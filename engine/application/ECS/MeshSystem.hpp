@@ -1,5 +1,8 @@
 ﻿#pragma once
 
+#include <utility>
+#include <vector>
+
 #include "Repository.hpp"
 
 namespace gestalt::foundation {
@@ -8,14 +11,54 @@ namespace gestalt::foundation {
 }
 
 namespace gestalt::application {
+  class SystemContext;
 
+  /**
+   * @brief Keeps the mesh draw buffer in sync with the scene.
+   *
+   * Every surface of an entity with a mesh owns a stable slot in the draw buffer for as long as it
+   * keeps its mesh. Only the slots of entities that moved, changed their mesh or changed their
+   * visibility are rewritten and uploaded. Visibility is only re-evaluated for the subtrees of
+   * nodes that changed. Hidden and released slots stay in the buffer with no meshlets, so the
+   * draw count is the highest slot in use.
+   */
     class MeshSystem final {
     IGpu& gpu_;
     IResourceAllocator& resource_allocator_;
     Repository& repository_;
     FrameProvider& frame_;
       size_t meshes_ = 0;
-      void traverse_scene(Entity entity, const TransformComponent& parent_transform);
+
+      // slots of one entity's surfaces in repository_.mesh_draws_
+      struct DrawRange {
+        Entity entity = invalid_entity;
+        uint32 first = 0;
+        uint32 count = 0;
+        bool visible = false;
+      };
+
+      std::vector<DrawRange> draw_ranges_;  // indexed by entity_index
+      std::vector<std::pair<uint32, uint32>> free_draws_;   // first, count
+      std::vector<std::pair<uint32, uint32>> dirty_draws_;  // first, count
+      uint64 last_mesh_version_ = 0;
+      uint64 last_node_version_ = 0;
+      uint64 last_hidden_version_ = 0;
+      uint64 visibility_pass_ = 0;
+      std::vector<Entity> visibility_roots_;  // subtrees whose visibility is re-evaluated
+      std::vector<uint64> root_passes_;       // indexed by entity_index, pass that queued it
+
+      [[nodiscard]] DrawRange* find_draw_range(Entity entity);
+      uint32 allocate_draws(uint32 count);
+      void release_draws(DrawRange& range);
+      void write_draws(const StorageOf<MeshComponent>& mesh_components, const DrawRange& range,
+                       const WorldTransformComponent& world_transform);
+      void hide_draws(const DrawRange& range);
+      void release_removed_draws(const StorageOf<MeshComponent>& mesh_components);
+      void assign_draws(const StorageOf<MeshComponent>& mesh_components);
+      void update_visibility(const StorageOf<MeshComponent>& mesh_components,
+                             const StorageOf<NodeComponent>& scene_graph,
+                             const StorageOf<HiddenComponent>& hidden_components);
+      void upload_dirty_draws();
       void upload_mesh();
 
       void create_buffers();
@@ -31,7 +74,7 @@ namespace gestalt::application {
       MeshSystem(MeshSystem&&) = delete;
       MeshSystem& operator=(MeshSystem&&) = delete;
 
-      void update();
+      void update(const SystemContext& context);
     };
 
 }  // namespace gestalt
\ No newline at end of file
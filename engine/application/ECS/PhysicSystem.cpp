@@ -17,7 +17,8 @@ namespace gestalt::application {
 
   
   PhysicSystem::PhysicSystem(IGpu& gpu, IResourceAllocator& resource_allocator,
-                             Repository& repository, FrameProvider& frame, EventBus& event_bus)
+                             Repository& repository, FrameProvider& frame, EventBus& event_bus,
+                             JobSystem& job_system)
       : gpu_(gpu),
         resource_allocator_(resource_allocator),
         repository_(repository),
@@ -25,21 +26,23 @@ namespace gestalt::application {
   event_bus_(event_bus)
   {
     physic_engine_ = std::make_unique<PhysicEngine>();
-    physic_engine_->init();
-
-    for (auto& [entity, physics_component] : repository_.physics_components.snapshot()) {
-      if (physics_component.collider_type == CAPSULE) {
-        player_ = entity;
-      }
-    }
+    physic_engine_->init(job_system);
+
+    repository_.physics_components.for_each(
+        [&](const Entity entity, const PhysicsComponent& physics_component) {
+          if (physics_component.collider_type == CAPSULE) {
+            player_ = entity;
+          }
+        });
   }
 
   void PhysicSystem::move_player(const float delta_time, const UserInput& movement) const {
     const auto player_physics = repository_.physics_components.find(player_);
-    if (player_physics->body == nullptr) return;
-    const auto player_transform = repository_.transform_components.find(player_);
+    if (player_physics == nullptr || player_physics->body == nullptr) return;
+    const auto player_transform = repository_.scene_hierarchy.world_transform(player_);
+    if (player_transform == nullptr) return;
 
-    auto orientation = player_transform->rotation();
+    auto orientation = player_transform->rotation;
     orientation.w *= -1; // Jolt uses a different handedness convention (i guess)
     glm::vec3 forward = orientation * glm::vec3(0, 0, -1);
     glm::vec3 right = orientation * glm::vec3(1, 0, 0);
@@ -76,18 +79,36 @@ namespace gestalt::application {
     }
   }
 
+  void PhysicSystem::release_body(const Entity entity) {
+    const auto physics_component = repository_.physics_components.find_mutable(entity);
+    if (physics_component == nullptr || physics_component->body == nullptr) {
+      return;
+    }
+
+    physic_engine_->remove_body(physics_component->body->GetID());
+    physics_component->body = nullptr;
+    physics_component->shape = nullptr;  // owned by the body
+
+    if (entity == player_) {
+      player_ = invalid_entity;
+    }
+  }
+
   void PhysicSystem::update(float delta_time, const UserInput& movement) const {
 
     move_player(delta_time, movement);
 
     physic_engine_->step_simulation(delta_time);
 
-    for (auto& [entity, physics_component] : repository_.physics_components.snapshot()) {
-
+    repository_.physics_components.for_each(
+        [&](const Entity entity, PhysicsComponent& physics_component) {
+      const auto transform = repository_.scene_hierarchy.world_transform(entity);
+      if (transform == nullptr) {
+        return;
+      }
       if (physics_component.body == nullptr) {
-        auto transform = repository_.transform_components.find(entity);
         physics_component.body = physic_engine_->create_body(
-            physics_component, transform->position(), transform->rotation());
+            physics_component, transform->position, transform->rotation);
       }
 
       if (physics_component.body_type == DYNAMIC) {
@@ -95,10 +116,20 @@ namespace gestalt::application {
         glm::quat orientation;
         physic_engine_->get_body_transform(physics_component.body, position,
                                            orientation);
-        event_bus_.emit<TranslateEntityEvent>({entity, position});
-        event_bus_.emit<RotateEntityEvent>({entity, orientation});
+        // bodies are simulated in world space, the events set the transform relative to the parent
+        if (const auto node = repository_.scene_graph.find(entity); node != nullptr) {
+          if (const auto parent = repository_.scene_hierarchy.world_transform(node->parent);
+              parent != nullptr && parent->scale != 0.f) {
+            const glm::quat inverse_rotation = glm::inverse(parent->rotation);
+            position = inverse_rotation * (position - parent->position) / parent->scale;
+            orientation = inverse_rotation * orientation;
+          }
+        }
+        event_bus_.emit<TransformEntityEvent>(
+            {entity, TransformEntityEvent::kPosition | TransformEntityEvent::kRotation, position,
+             orientation, 1.f});
       }
-    }
+    });
   }
 
 }  // namespace gestalt::application
\ No newline at end of file
@@ -10,7 +10,6 @@ namespace gestalt::application {
 namespace JPH {
   class Body;
   class BodyID;
-  class JobSystemThreadPool;
   class TempAllocatorImpl;
   class BodyInterface;
   class PhysicsSystem;
@@ -18,6 +17,7 @@ namespace JPH {
 
 namespace gestalt::foundation {
   struct FrameProvider;
+  class JobSystem;
   class IResourceAllocator;
   struct UserInput;
 }
@@ -34,7 +34,7 @@ namespace gestalt::application {
       Entity player_ = invalid_entity;
     public:
       PhysicSystem(IGpu& gpu, IResourceAllocator& resource_allocator, Repository& repository,
-                   FrameProvider& frame, EventBus& event_bus);
+                   FrameProvider& frame, EventBus& event_bus, JobSystem& job_system);
       ~PhysicSystem() = default;
 
       PhysicSystem(const PhysicSystem&) = delete;
@@ -44,6 +44,7 @@ namespace gestalt::application {
       PhysicSystem& operator=(PhysicSystem&&) = delete;
 
       void move_player(float delta_time, const UserInput& movement) const;
+      void release_body(Entity entity);
       void update(float delta_time, const UserInput& movement) const;
     };
 
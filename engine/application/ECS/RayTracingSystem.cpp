@@ -9,6 +9,7 @@
 #include <fmt/core.h>
 
 #include "FrameProvider.hpp"
+#include "SystemContext.hpp"
 #include "Interface/IGpu.hpp"
 #include "Interface/IResourceAllocator.hpp"
 #include "Mesh/MeshSurface.hpp"
@@ -23,16 +24,14 @@ namespace gestalt::application {
         frame_(frame)
   {}
 
-  void RayTracingSystem::build_tlas() {
+  void RayTracingSystem::build_tlas(const SystemContext& context) {
     // TODO: This is a TLAS build, not an update, and probably should be refactored to some other
     // place. But! It works 💀
     /**
      * TLAS "Update"
      */
-    const auto root_transform = TransformComponent();
-
     std::vector<VkAccelerationStructureInstanceKHR> tlasInstances;
-    collect_tlas_instance_data(root_entity, root_transform, tlasInstances);
+    collect_tlas_instance_data(context, tlasInstances);
 
     if (repository_.tlas != nullptr) {
       vkDestroyAccelerationStructureKHR(gpu_.getDevice(),
@@ -353,58 +352,71 @@ namespace gestalt::application {
   }
 
   void RayTracingSystem::collect_tlas_instance_data(
-      Entity entity, const TransformComponent& parent_transform,
-      std::vector<VkAccelerationStructureInstanceKHR>& data) {
-    const auto node = repository_.scene_graph.find(entity);
-    if (!node->visible) {
-      return;
-    }
-
-    const auto localTransform = repository_.transform_components.find(entity);
-    TransformComponent worldTransform = parent_transform * *localTransform;
-
-    const auto meshComponent = repository_.mesh_components.find(entity);
-    if (meshComponent != nullptr) {
-      const auto& mesh = repository_.meshes.get(meshComponent->mesh);
-      for (const auto surface : mesh.surfaces) {
-        if (surface.bottom_level_as != no_component) {
-          auto blas_address
-              = repository_.ray_tracing_buffer
-                                   ->bottom_level_acceleration_structures[surface.bottom_level_as]->address;
-          VkAccelerationStructureInstanceKHR instance = {};
-          instance.flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR;
-          instance.mask = 0xff;
-          instance.instanceShaderBindingTableRecordOffset = 0;
-          instance.accelerationStructureReference = blas_address;
-
-          glm::mat4 T = glm::translate(glm::mat4(1.0f), worldTransform.position());
-          glm::mat4 R = glm::mat4_cast(worldTransform.rotation());
-          glm::mat4 S = glm::scale(glm::mat4(1.0f), worldTransform.scale());
-          glm::mat4 m = T * R * S;
-
-          instance.transform = {
-              m[0].x, m[1].x, m[2].x, m[3].x, m[0].y, m[1].y,
-              m[2].y, m[3].y, m[0].z, m[1].z, m[2].z, m[3].z,
-          };
-
-          data.push_back(instance);
+      const SystemContext& context, std::vector<VkAccelerationStructureInstanceKHR>& data) const {
+    const auto& scene_graph = context.read<NodeComponent>();
+    const auto& hidden_components = context.read<HiddenComponent>();
+    const auto& hierarchy = repository_.scene_hierarchy;
+
+    // a hidden node hides its whole subtree; most scenes hide nothing and skip the walk
+    const auto is_visible = [&](const Entity entity, const NodeComponent& node) {
+      if (hidden_components.empty()) {
+        return true;
+      }
+      if (hidden_components.contains(entity)) {
+        return false;
+      }
+      for (Entity ancestor = node.parent; ancestor != invalid_entity;) {
+        if (hidden_components.contains(ancestor)) {
+          return false;
         }
+        const auto ancestor_node = scene_graph.find(ancestor);
+        ancestor = ancestor_node != nullptr ? ancestor_node->parent : invalid_entity;
       }
-    }
+      return true;
+    };
 
-    for (const auto& childEntity : node->children) {
-      collect_tlas_instance_data(childEntity, worldTransform, data);
-    }
+    // driven by the mesh storage, so nodes without geometry are never visited
+    context.view<const MeshComponent, const NodeComponent>().for_each(
+        [&](const Entity entity, const MeshComponent& meshComponent, const NodeComponent& node) {
+          const auto worldTransform = hierarchy.world_transform(entity);
+          if (worldTransform == nullptr || !is_visible(entity, node)) {
+            return;
+          }
+
+          const auto& mesh = repository_.meshes.get(meshComponent.mesh);
+          for (const auto surface : mesh.surfaces) {
+            if (surface.bottom_level_as == no_component) {
+              continue;
+            }
+            auto blas_address
+                = repository_.ray_tracing_buffer
+                      ->bottom_level_acceleration_structures[surface.bottom_level_as]->address;
+            VkAccelerationStructureInstanceKHR instance = {};
+            instance.flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR;
+            instance.mask = 0xff;
+            instance.instanceShaderBindingTableRecordOffset = 0;
+            instance.accelerationStructureReference = blas_address;
+
+            const glm::mat4& m = worldTransform->matrix;
+
+            instance.transform = {
+                m[0].x, m[1].x, m[2].x, m[3].x, m[0].y, m[1].y,
+                m[2].y, m[3].y, m[0].z, m[1].z, m[2].z, m[3].z,
+            };
+
+            data.push_back(instance);
+          }
+        });
   }
 
-  void RayTracingSystem::update() {
+  void RayTracingSystem::update(const SystemContext& context) {
     if (!isVulkanRayTracingEnabled()) {
       return;
     }
 
     if (repository_.meshes.size() != meshes_) {
       build_blas();
-      build_tlas();
+      build_tlas(context);
       meshes_ = repository_.meshes.size();
     }
   }
@@ -8,6 +8,7 @@ namespace gestalt::foundation {
 }
 
 namespace gestalt::application {
+  class SystemContext;
 
     class RayTracingSystem final {
     IGpu& gpu_;
@@ -17,9 +18,9 @@ namespace gestalt::application {
       size_t meshes_ = 0;
 
       void build_blas();
-      void build_tlas();
-      void collect_tlas_instance_data(Entity entity, const TransformComponent& parent_transform,
-                                      std::vector<VkAccelerationStructureInstanceKHR>& data);
+      void build_tlas(const SystemContext& context);
+      void collect_tlas_instance_data(const SystemContext& context,
+                                      std::vector<VkAccelerationStructureInstanceKHR>& data) const;
 
     public:
       RayTracingSystem(IGpu& gpu, IResourceAllocator& resource_allocator, Repository& repository,
@@ -32,7 +33,7 @@ namespace gestalt::application {
       RayTracingSystem(RayTracingSystem&&) = delete;
       RayTracingSystem& operator=(RayTracingSystem&&) = delete;
 
-      void update();
+      void update(const SystemContext& context);
     };
 
 }  // namespace gestalt
\ No newline at end of file
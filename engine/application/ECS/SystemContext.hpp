@@ -0,0 +1,93 @@
+﻿#pragma once
+
+#include <cassert>
+#include <string_view>
+#include <type_traits>
+#include <fmt/core.h>
+
+#include "Repository.hpp"
+#include "SystemScheduler.hpp"
+
+namespace gestalt::application {
+
+  template <typename> inline constexpr bool kUnmappedComponent = false;
+
+  /** @brief The resource a component storage belongs to in system access declarations. */
+  template <typename ComponentType> constexpr SystemResource resource_of() {
+    using T = std::remove_const_t<ComponentType>;
+    using enum SystemResource;
+    if constexpr (std::is_same_v<T, NodeComponent> || std::is_same_v<T, HiddenComponent>
+                  || std::is_same_v<T, StaticComponent>) {
+      return kSceneGraph;
+    } else if constexpr (std::is_same_v<T, TransformComponent>) {
+      return kTransformComponents;
+    } else if constexpr (std::is_same_v<T, MeshComponent>) {
+      return kMeshComponents;
+    } else if constexpr (std::is_same_v<T, AnimationCameraComponent>
+                         || std::is_same_v<T, FirstPersonCameraComponent>
+                         || std::is_same_v<T, FreeFlyCameraComponent>
+                         || std::is_same_v<T, OrbitCameraComponent>
+                         || std::is_same_v<T, PerspectiveProjectionComponent>
+                         || std::is_same_v<T, OrthographicProjectionComponent>) {
+      return kCameraComponents;
+    } else if constexpr (std::is_same_v<T, DirectionalLightComponent>
+                         || std::is_same_v<T, PointLightComponent>
+                         || std::is_same_v<T, SpotLightComponent>) {
+      return kLightComponents;
+    } else if constexpr (std::is_same_v<T, AnimationComponent>) {
+      return kAnimationComponents;
+    } else if constexpr (std::is_same_v<T, PhysicsComponent>) {
+      return kPhysicsComponents;
+    } else {
+      static_assert(kUnmappedComponent<T>, "component type has no system resource");
+    }
+  }
+
+  /**
+   * @brief Component storage access of one system run, handed to the system by the scheduler.
+   *
+   * read<T>() and write<T>() return the storage of T. With validation enabled they check that
+   * the system declared the storage's resource, so undeclared reads and in-place edits through
+   * find_mutable or for_each are caught where they happen rather than by comparing versions.
+   */
+  class SystemContext final {
+    Repository& repository_;
+    std::string_view system_;
+    SystemAccess access_;
+    bool checked_;
+
+    void check(const SystemResource resource, const bool write) const {
+      if (!checked_) {
+        return;
+      }
+      const uint64 allowed = write ? access_.writes : access_.reads | access_.writes;
+      if ((allowed & SystemAccess::bit(resource)) == 0) {
+        fmt::println("System '{}' {} resource {} without declaring it", system_,
+                     write ? "writes" : "reads", static_cast<uint32>(resource));
+        assert(false && "undeclared resource access in system");
+      }
+    }
+
+  public:
+    SystemContext(Repository& repository, const std::string_view system,
+                  const SystemAccess access, const bool checked)
+        : repository_(repository), system_(system), access_(access), checked_(checked) {}
+
+    template <typename ComponentType> [[nodiscard]] const StorageOf<ComponentType>& read() const {
+      check(resource_of<ComponentType>(), false);
+      return repository_.storage<ComponentType>();
+    }
+
+    template <typename ComponentType> [[nodiscard]] StorageOf<ComponentType>& write() const {
+      check(resource_of<ComponentType>(), true);
+      return repository_.storage<ComponentType>();
+    }
+
+    /** @brief Repository::view with a read check for const types and a write check otherwise. */
+    template <typename... ComponentTypes> [[nodiscard]] auto view() const {
+      (check(resource_of<ComponentTypes>(), !std::is_const_v<ComponentTypes>), ...);
+      return repository_.view<ComponentTypes...>();
+    }
+  };
+
+}  // namespace gestalt::application
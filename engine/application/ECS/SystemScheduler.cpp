@@ -0,0 +1,128 @@
+﻿#include "SystemScheduler.hpp"
+
+#include <cassert>
+#include <utility>
+#include <fmt/core.h>
+
+#include "JobSystem.hpp"
+#include "Repository.hpp"
+#include "SystemContext.hpp"
+#include "Events/EventBus.hpp"
+
+namespace gestalt::application {
+
+  SystemScheduler::SystemScheduler(Repository& repository, EventBus& event_bus,
+                                   JobSystem& job_system)
+      : repository_(repository), event_bus_(event_bus), job_system_(job_system) {}
+
+  void SystemScheduler::add_system(std::string name, SystemAccess access,
+                                   std::function<void(const SystemContext&)> update) {
+    const size_t index = systems_.size();
+    System system{std::move(name), access, std::move(update), {}, 0};
+
+    for (size_t earlier = 0; earlier < index; ++earlier) {
+      if (systems_[earlier].access.conflicts_with(access)) {
+        systems_[earlier].dependents.push_back(index);
+        ++system.dependency_count;
+      }
+    }
+
+    systems_.push_back(std::move(system));
+  }
+
+  void SystemScheduler::run() {
+    if (validate_) {
+      run_validated();
+    } else {
+      run_parallel();
+    }
+  }
+
+  void SystemScheduler::run_parallel() {
+    if (pending_dependencies_.size() != systems_.size()) {
+      pending_dependencies_ = std::vector<std::atomic<uint32>>(systems_.size());
+    }
+    for (size_t i = 0; i < systems_.size(); ++i) {
+      pending_dependencies_[i].store(systems_[i].dependency_count, std::memory_order_relaxed);
+    }
+
+    // dependents are scheduled before the job that released them finishes, so the counter only
+    // drops to zero once every system ran
+    JobCounter counter;
+    for (size_t i = 0; i < systems_.size(); ++i) {
+      if (systems_[i].dependency_count == 0) {
+        job_system_.schedule([this, i, &counter] { execute(i, counter); }, &counter);
+      }
+    }
+    job_system_.wait(counter);
+
+    if (error_) {
+      std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+  }
+
+  void SystemScheduler::execute(const size_t system, JobCounter& counter) {
+    try {
+      const System& current = systems_[system];
+      current.update(SystemContext(repository_, current.name, current.access, false));
+    } catch (...) {
+      const std::lock_guard lock(error_mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+    }
+
+    for (const size_t dependent : systems_[system].dependents) {
+      if (pending_dependencies_[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        job_system_.schedule([this, dependent, &counter] { execute(dependent, counter); },
+                             &counter);
+      }
+    }
+  }
+
+  void SystemScheduler::run_validated() {
+    for (const auto& system : systems_) {
+      const auto before = resource_versions();
+      system.update(SystemContext(repository_, system.name, system.access, true));
+      const auto after = resource_versions();
+
+      for (uint32 resource = 0; resource < before.size(); ++resource) {
+        const uint64 bit = uint64{1} << resource;
+        if (before[resource] != after[resource] && (system.access.writes & bit) == 0) {
+          fmt::println("System '{}' modified resource {} without declaring write access",
+                       system.name, resource);
+          assert(false && "undeclared write access in system");
+        }
+      }
+    }
+  }
+
+  std::vector<uint64> SystemScheduler::resource_versions() const {
+    std::vector<uint64> versions(static_cast<size_t>(SystemResource::kCount), 0);
+    const auto set = [&versions](SystemResource resource, const uint64 version) {
+      versions[static_cast<size_t>(resource)] = version;
+    };
+
+    set(SystemResource::kSceneGraph,
+        repository_.scene_graph.version() + repository_.hidden_components.version());
+    set(SystemResource::kTransformComponents, repository_.transform_components.version());
+    set(SystemResource::kMeshComponents, repository_.mesh_components.version());
+    set(SystemResource::kCameraComponents,
+        repository_.animation_camera_components.version()
+            + repository_.first_person_camera_components.version()
+            + repository_.free_fly_camera_components.version()
+            + repository_.orbit_camera_components.version()
+            + repository_.perspective_projection_components.version()
+            + repository_.orthographic_projection_components.version());
+    set(SystemResource::kLightComponents,
+        repository_.directional_light_components.version()
+            + repository_.point_light_components.version()
+            + repository_.spot_light_components.version());
+    set(SystemResource::kAnimationComponents, repository_.animation_components.version());
+    set(SystemResource::kPhysicsComponents, repository_.physics_components.version());
+    set(SystemResource::kEventBus, event_bus_.pending_events());
+
+    return versions;
+  }
+
+}  // namespace gestalt::application
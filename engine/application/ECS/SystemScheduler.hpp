@@ -0,0 +1,128 @@
+﻿#pragma once
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+namespace gestalt::foundation {
+  class JobCounter;
+  class JobSystem;
+  class Repository;
+}
+
+namespace gestalt::application {
+  class EventBus;
+  class SystemContext;
+
+  /**
+   * @brief Shared state a system may touch while the scene is updated.
+   */
+  enum class SystemResource : uint32 {
+    kSceneGraph,
+    kTransformComponents,
+    kMeshComponents,
+    kCameraComponents,  // camera and projection storages
+    kLightComponents,
+    kAnimationComponents,
+    kPhysicsComponents,
+    kMaterials,
+    kMeshData,    // meshes, mesh draws and their GPU buffers
+    kLightData,   // GPU light containers and light buffers
+    kPerFrameData,
+    kAccelerationStructures,
+    kSceneBvh,       // scene_bvh and static_bvh
+    kGpuSubmission,  // immediate submits and resource creation
+    kEventBus,
+    kCount
+  };
+
+  /**
+   * @brief Read and write declaration of a system. Two systems conflict if one of them writes a
+   * resource the other one reads or writes.
+   */
+  struct SystemAccess {
+    uint64 reads = 0;
+    uint64 writes = 0;
+
+    SystemAccess& read(const SystemResource resource) {
+      reads |= bit(resource);
+      return *this;
+    }
+
+    SystemAccess& write(const SystemResource resource) {
+      writes |= bit(resource);
+      return *this;
+    }
+
+    [[nodiscard]] bool conflicts_with(const SystemAccess& other) const {
+      return (writes & (other.reads | other.writes)) != 0 || (other.writes & reads) != 0;
+    }
+
+    static constexpr uint64 bit(SystemResource resource) {
+      return uint64{1} << static_cast<uint32>(resource);
+    }
+  };
+
+  /**
+   * @brief Runs the ECS systems of one frame on the job system.
+   *
+   * A system depends on every system registered before it that it conflicts with, so each
+   * resource sees its readers and writers in registration order and the result matches running
+   * the systems one after another. Systems without conflicts run concurrently, the calling thread
+   * helps executing them while it waits.
+   *
+   * Every system gets a SystemContext for its component storages. With validation enabled the
+   * systems run serially, the context asserts on storages the system did not declare, and the
+   * storage versions and the event queue are compared around each system as a backstop for
+   * writes that bypass the context.
+   */
+  class SystemScheduler final {
+    struct System {
+      std::string name;
+      SystemAccess access;
+      std::function<void(const SystemContext&)> update;
+      std::vector<size_t> dependents;
+      uint32 dependency_count = 0;
+    };
+
+    Repository& repository_;
+    EventBus& event_bus_;
+    JobSystem& job_system_;
+    std::vector<System> systems_;
+    bool validate_ = false;
+
+    std::vector<std::atomic<uint32>> pending_dependencies_;
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+
+    void run_parallel();
+    void run_validated();
+    void execute(size_t system, JobCounter& counter);
+    [[nodiscard]] std::vector<uint64> resource_versions() const;
+
+  public:
+    SystemScheduler(Repository& repository, EventBus& event_bus, JobSystem& job_system);
+    ~SystemScheduler() = default;
+
+    SystemScheduler(const SystemScheduler&) = delete;
+    SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+    SystemScheduler(SystemScheduler&&) = delete;
+    SystemScheduler& operator=(SystemScheduler&&) = delete;
+
+    void add_system(std::string name, SystemAccess access,
+                    std::function<void(const SystemContext&)> update);
+
+    /** @brief Runs every registered system once and returns when all of them finished. */
+    void run();
+
+    void set_validation_enabled(const bool enabled) { validate_ = enabled; }
+    [[nodiscard]] bool is_validation_enabled() const { return validate_; }
+  };
+
+}  // namespace gestalt::application
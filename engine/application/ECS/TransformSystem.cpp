@@ -1,6 +1,7 @@
 ﻿#include "TransformSystem.hpp"
 
 #include "Repository.hpp"
+#include "SystemContext.hpp"
 #include "Events/EventBus.hpp"
 #include "Events/Events.hpp"
 
@@ -8,166 +9,236 @@ namespace gestalt::application {
 
   TransformSystem::TransformSystem(Repository& repository, EventBus& event_bus)
       : repository_(repository) {
-    event_bus.subscribe<MoveEntityEvent>([this](const MoveEntityEvent& event) {
+    event_bus.subscribe<TransformEntityEvent>([this](const TransformEntityEvent& event) {
       auto transform = repository_.transform_components.find_mutable(event.entity);
-      transform->set_position(event.new_position);
-      transform->set_rotation(event.new_rotation);
-      transform->set_scale(event.new_scale);
-      transform->is_dirty = true;
-    });
-    event_bus.subscribe<TranslateEntityEvent>([this](const TranslateEntityEvent& event) {
-      auto transform = repository_.transform_components.find_mutable(event.entity);
-      transform->set_position(event.new_position);
-      transform->is_dirty = true;
-    });
-    event_bus.subscribe<RotateEntityEvent>([this](const RotateEntityEvent& event) {
-      auto transform = repository_.transform_components.find_mutable(event.entity);
-      transform->set_rotation(event.new_rotation);
-      transform->is_dirty = true;
-    });
-    event_bus.subscribe<ScaleEntityEvent>([this](const ScaleEntityEvent& event) {
-      auto transform = repository_.transform_components.find_mutable(event.entity);
-      transform->set_scale(event.new_scale);
-      transform->is_dirty = true;
+      if (transform == nullptr) {
+        return;
+      }
+      if (event.fields & TransformEntityEvent::kPosition) {
+        transform->set_position(event.new_position);
+      }
+      if (event.fields & TransformEntityEvent::kRotation) {
+        transform->set_rotation(event.new_rotation);
+      }
+      if (event.fields & TransformEntityEvent::kScale) {
+        transform->set_scale(event.new_scale);
+      }
+      repository_.transform_components.mark_changed(event.entity);
     });
   }
 
+  TransformSystem::~TransformSystem() = default;
+
   glm::mat4 TransformSystem::get_model_matrix(const TransformComponent& transform) {
     return translate(glm::mat4(1.0f), transform.position()) * mat4_cast(transform.rotation())
            * scale(glm::mat4(1.0f), glm::vec3(transform.scale()));
   }
 
-  void TransformSystem::mark_parent_bounds_dirty(Entity entity) {
-    if (entity == invalid_entity) {
-      return;
-    }
-
-    const auto node = repository_.scene_graph.find_mutable(entity);
-    if (node->bounds.is_dirty) {
-      return;
+  AABB TransformSystem::local_bounds(const SystemContext& context, const Entity entity) const {
+    AABB aabb;
+    if (const auto mesh_component = context.read<MeshComponent>().find(entity);
+        mesh_component != nullptr) {
+      const auto& mesh = repository_.meshes.get(mesh_component->mesh);
+      aabb.min = mesh.local_bounds.center - glm::vec3(mesh.local_bounds.radius);
+      aabb.max = mesh.local_bounds.center + glm::vec3(mesh.local_bounds.radius);
+    } else {
+      // nodes without mesh components should still influence the bounds
+      aabb.min = glm::vec3(-0.0001f);
+      aabb.max = glm::vec3(0.0001f);
     }
-
-    node->bounds.is_dirty = true;
-    mark_parent_bounds_dirty(node->parent);
+    return aabb;
   }
 
-  void TransformSystem::mark_children_bounds_dirty(Entity entity) {
-    if (entity == invalid_entity) {
-      return;
-    }
-
-    const auto node = repository_.scene_graph.find_mutable(entity);
-    if (node->bounds.is_dirty) {
-      return;
-    }
-
-    node->bounds.is_dirty = true;
-    for (const auto& child : node->children) {
-      mark_children_bounds_dirty(child);
+  void TransformSystem::queue_world_update(const uint32 depth, const uint32 slot) {
+    if (!world_queued_[depth][slot]) {
+      world_queued_[depth][slot] = 1;
+      world_queue_[depth].push_back(slot);
     }
   }
 
-  void TransformSystem::mark_bounds_as_dirty(Entity entity) {
-    const auto node = repository_.scene_graph.find_mutable(entity);
-    node->bounds.is_dirty = true;
-    for (const auto& child : node->children) {
-      mark_children_bounds_dirty(child);
+  void TransformSystem::queue_bounds_update(const uint32 depth, const uint32 slot) {
+    if (!bounds_queued_[depth][slot]) {
+      bounds_queued_[depth][slot] = 1;
+      bounds_queue_[depth].push_back(slot);
     }
-    mark_parent_bounds_dirty(node->parent);
   }
 
-  void TransformSystem::update_aabb(const Entity entity,
-                                    const TransformComponent& parent_transform) {
-    auto node = repository_.scene_graph.find_mutable(entity);
-    if (!node->bounds.is_dirty) {
-      return;
-    }
-    auto local_transform = repository_.transform_components.find_mutable(entity);
-    if (node->parent != invalid_entity) {
-      const auto& parent_transform_component = repository_.transform_components.find(node->parent);
-      local_transform->parent_position = parent_transform_component->position();
-      local_transform->parent_rotation = parent_transform_component->rotation();
-      local_transform->parent_scale = parent_transform_component->scale().x;
-    } else {
-      local_transform->parent_position = local_transform->position();
-      local_transform->parent_rotation = local_transform->rotation();
-      local_transform->parent_scale = local_transform->scale().x;
-    }
-
-    const auto& mesh_component = repository_.mesh_components.find(entity);
-
-    AABB aabb;
-    auto& [min, max, is_dirty] = aabb;
+  void TransformSystem::update_world_transforms(const SystemContext& context) {
+    auto& hierarchy = repository_.scene_hierarchy;
+    const auto& transform_components = context.read<TransformComponent>();
 
-    if (mesh_component != nullptr) {
-      const auto& mesh = repository_.meshes.get(mesh_component->mesh);
-      AABB local_aabb;
-      local_aabb.min = mesh.local_bounds.center - glm::vec3(mesh.local_bounds.radius);
-      local_aabb.max = mesh.local_bounds.center + glm::vec3(mesh.local_bounds.radius);
+    // top-down, a recomputed node queues its children in the next level
+    for (uint32 depth = 0; depth < hierarchy.level_count(); ++depth) {
+      auto& queue = world_queue_[depth];
+      if (queue.empty()) {
+        continue;
+      }
+      const auto& level = hierarchy.level(depth);
+
+      // parents are final at this point, the level above was written in the previous iteration
+      parent_batch_.resize(queue.size());
+      local_batch_.resize(queue.size());
+      for (size_t i = 0; i < queue.size(); ++i) {
+        const uint32 slot = queue[i];
+        const uint32 parent = level.parents[slot];
+        if (parent != SceneHierarchy::kNoParent) {
+          const auto& parent_world = hierarchy.world_transforms(depth - 1)[parent];
+          parent_batch_.set(i, parent_world.position, parent_world.rotation, parent_world.scale);
+        } else {
+          parent_batch_.set(i, glm::vec3(0.f), glm::quat(1.f, 0.f, 0.f, 0.f), 1.f);
+        }
+
+        const auto local = transform_components.find(level.entities[slot]);
+        const TransformComponent local_transform = local != nullptr ? *local : TransformComponent();
+        local_batch_.set(i, local_transform.position(), local_transform.rotation(),
+                         local_transform.scale_uniform());
+      }
 
-      min = glm::min(min, local_aabb.min);
-      max = glm::max(max, local_aabb.max);
-    } else {
-      // nodes without mesh components should still influence the bounds
-      min = glm::vec3(-0.0001f);
-      max = glm::vec3(0.0001f);
+      compose_transforms(parent_batch_, local_batch_, world_batch_);
+
+      const auto world_transforms = hierarchy.world_transforms(depth);
+      for (size_t i = 0; i < queue.size(); ++i) {
+        const uint32 slot = queue[i];
+        world_transforms[slot] = WorldTransformComponent(
+            world_batch_.position(i), world_batch_.rotation(i), world_batch_.scale[i]);
+        hierarchy.mark_moved(level.entities[slot]);
+        queue_bounds_update(depth, slot);
+        world_queued_[depth][slot] = 0;
+        hierarchy.for_each_child(depth, slot,
+                                 [&](const uint32 child) { queue_world_update(depth + 1, child); });
+      }
+      queue.clear();
     }
+  }
 
-    const TransformComponent model_transform = parent_transform * *local_transform;
-    for (const auto& child : node->children) {
-      update_aabb(child, model_transform);
-      const auto& child_aabb = repository_.scene_graph.find(child)->bounds;
-      min.x = std::min(min.x, child_aabb.min.x);
-      min.y = std::min(min.y, child_aabb.min.y);
-      min.z = std::min(min.z, child_aabb.min.z);
-
-      max.x = std::max(max.x, child_aabb.max.x);
-      max.y = std::max(max.y, child_aabb.max.y);
-      max.z = std::max(max.z, child_aabb.max.z);
-    }
+  void TransformSystem::update_bounds(const SystemContext& context) {
+    const auto& hierarchy = repository_.scene_hierarchy;
+    const auto& mesh_components = context.read<MeshComponent>();
+    const auto& static_components = context.read<StaticComponent>();
+    auto& scene_graph = context.write<NodeComponent>();
+    size_t movable_insertions = 0;
+    size_t static_insertions = 0;
+
+    // bottom-up, so the bounds of all children are final before their parent is refit. A parent
+    // is only queued if the bounds of its child changed.
+    for (uint32 depth = static_cast<uint32>(hierarchy.level_count()); depth-- > 0;) {
+      auto& queue = bounds_queue_[depth];
+      if (queue.empty()) {
+        continue;
+      }
+      const auto& level = hierarchy.level(depth);
+
+      local_bounds_batch_.resize(queue.size());
+      world_batch_.resize(queue.size());
+      for (size_t i = 0; i < queue.size(); ++i) {
+        const uint32 slot = queue[i];
+        const AABB local = local_bounds(context, level.entities[slot]);
+        local_bounds_batch_.set(i, (local.min + local.max) * 0.5f, (local.max - local.min) * 0.5f);
+        const auto& world = level.world_transforms[slot];
+        world_batch_.set(i, world.position, world.rotation, world.scale);
+      }
 
-    // Decompose model_matrix into translation (T) and 3x3 rotation matrix (M)
-    glm::vec3 T = model_transform.position();             // Translation vector
-    glm::vec3 S = glm::vec3(model_transform.scale());                // Scale vector
-    glm::mat3 M = glm::mat3(model_transform.rotation());  // Rotation matrix
-    M = transpose(M);  // Otherwise the AABB will be rotated in the wrong direction
-
-    AABB transformedAABB = {T, T};  // Start with a zero-volume AABB at T
-
-    // Applying Arvo's method to adjust AABB based on rotation and translation
-    // NOTE: does not work for non-uniform scaling
-    for (int i = 0; i < 3; ++i) {
-      for (int j = 0; j < 3; ++j) {
-        float a = M[i][j] * S[j] * min[j];
-        float b = M[i][j] * S[j] * max[j];
-        transformedAABB.min[i] += a < b ? a : b;
-        transformedAABB.max[i] += a < b ? b : a;
+      transform_bounds(world_batch_, local_bounds_batch_, world_bounds_batch_);
+
+      for (size_t i = 0; i < queue.size(); ++i) {
+        const uint32 slot = queue[i];
+        bounds_queued_[depth][slot] = 0;
+
+        const auto node = scene_graph.find_mutable(level.entities[slot]);
+        if (node == nullptr) {
+          continue;
+        }
+
+        // a node without geometry only passes on the bounds of its children, so moving a
+        // camera or light leaves the bounds of its ancestors untouched
+        AABB aabb;
+        if (node->contributes_to_bounds) {
+          const glm::vec3 center = world_bounds_batch_.center(i);
+          const glm::vec3 extent = world_bounds_batch_.extent(i);
+          aabb.min = center - extent;
+          aabb.max = center + extent;
+        }
+
+        // the scene BVHs hold the entity's own box, not the union with its children. Static
+        // entities live in their own tree, which is built once and never refit by movers.
+        const Entity entity = level.entities[slot];
+        const bool is_static = static_components.contains(entity);
+        auto& bvh = is_static ? repository_.static_bvh : repository_.scene_bvh;
+        auto& other_bvh = is_static ? repository_.scene_bvh : repository_.static_bvh;
+        other_bvh.remove(entity);
+        if (node->contributes_to_bounds && mesh_components.find(entity) != nullptr) {
+          (is_static ? static_insertions : movable_insertions) += bvh.update(entity, aabb) ? 1 : 0;
+        } else {
+          bvh.remove(entity);
+        }
+
+        hierarchy.for_each_child(depth, slot, [&](const uint32 child) {
+          const Entity child_entity = hierarchy.level(depth + 1).entities[child];
+          if (const auto child_node = scene_graph.find(child_entity);
+              child_node != nullptr) {
+            aabb.min = glm::min(aabb.min, child_node->bounds.min);
+            aabb.max = glm::max(aabb.max, child_node->bounds.max);
+          }
+        });
+
+        if (!node->bounds.is_dirty && node->bounds.min == aabb.min
+            && node->bounds.max == aabb.max) {
+          continue;
+        }
+        node->bounds = aabb;
+        node->bounds.is_dirty = false;
+
+        if (level.parents[slot] != SceneHierarchy::kNoParent) {
+          queue_bounds_update(depth - 1, level.parents[slot]);
+        }
       }
+      queue.clear();
     }
-    min = transformedAABB.min;
-    max = transformedAABB.max;
-
 
-    node->bounds = aabb;
-    node->bounds.is_dirty = false;
+    // incremental insertion degrades a tree when most of it arrived at once, e.g. on load. The
+    // static tree is rebuilt after any larger batch, it is not touched again afterwards.
+    if (movable_insertions > 1024 && movable_insertions * 2 > repository_.scene_bvh.size()) {
+      repository_.scene_bvh.rebuild();
+    }
+    if (static_insertions > 64) {
+      repository_.static_bvh.rebuild();
+    }
   }
 
-  void TransformSystem::update() {
-    bool is_dirty = false;
+  void TransformSystem::update(const SystemContext& context) {
+    auto& hierarchy = repository_.scene_hierarchy;
+    hierarchy.clear_moved();
+
+    const size_t level_count = hierarchy.level_count();
+    world_queue_.resize(level_count);
+    bounds_queue_.resize(level_count);
+    world_queued_.resize(level_count);
+    bounds_queued_.resize(level_count);
+    for (uint32 depth = 0; depth < level_count; ++depth) {
+      world_queued_[depth].resize(hierarchy.level(depth).size(), 0);
+      bounds_queued_[depth].resize(hierarchy.level(depth).size(), 0);
+    }
 
-    for (auto& [entity, transform] : repository_.transform_components.snapshot()) {
-      if (transform.is_dirty) {
-        is_dirty = true;
-        mark_bounds_as_dirty(entity);
-        transform.is_dirty = false;
+    const auto& transform_components = context.read<TransformComponent>();
+    transform_components.for_each_changed_since(
+        last_seen_version_, [&](const Entity entity, const TransformComponent&) {
+          if (hierarchy.contains(entity)) {
+            queue_world_update(hierarchy.depth(entity), hierarchy.slot(entity));
+          }
+        });
+    last_seen_version_ = transform_components.version();
+
+    // nodes that lost a child or their own share keep their world transform, only their bounds
+    // are refit
+    for (const Entity entity : hierarchy.stale_bounds()) {
+      if (hierarchy.contains(entity)) {
+        queue_bounds_update(hierarchy.depth(entity), hierarchy.slot(entity));
       }
     }
+    hierarchy.clear_stale_bounds();
 
-    if (is_dirty) {
-      const auto root_transform = TransformComponent();
-
-      update_aabb(root_entity, root_transform);
-    }
+    update_world_transforms(context);
+    update_bounds(context);
   }
 
 }  // namespace gestalt::application
\ No newline at end of file
@@ -1,27 +1,48 @@
 ﻿#pragma once
+#include <vector>
+
 #include <Components/Entity.hpp>
+#include <TransformBatch.hpp>
 
 #include "glm/fwd.hpp"
 
 namespace gestalt::foundation {
+  struct AABB;
   struct TransformComponent;
+  struct WorldTransformComponent;
   class Repository;
 }
 
 namespace gestalt::application {
   class EventBus;
+  class SystemContext;
 
   class TransformSystem final {
       Repository& repository_;
-
-      void mark_children_bounds_dirty(Entity entity);
-      void mark_bounds_as_dirty(Entity entity);
-      void update_aabb(Entity entity, const TransformComponent& parent_transform);
-      void mark_parent_bounds_dirty(Entity entity);
+      uint64 last_seen_version_ = 0;
+
+      // per hierarchy level: slots waiting for the pass and a flag per slot to queue them once
+      std::vector<std::vector<uint32>> world_queue_;
+      std::vector<std::vector<uint32>> bounds_queue_;
+      std::vector<std::vector<uint8>> world_queued_;
+      std::vector<std::vector<uint8>> bounds_queued_;
+
+      // batched inputs and results of the level being processed
+      TransformBatch parent_batch_;
+      TransformBatch local_batch_;
+      TransformBatch world_batch_;
+      BoundsBatch local_bounds_batch_;
+      BoundsBatch world_bounds_batch_;
+
+      [[nodiscard]] AABB local_bounds(const SystemContext& context, Entity entity) const;
+      void queue_world_update(uint32 depth, uint32 slot);
+      void queue_bounds_update(uint32 depth, uint32 slot);
+      void update_world_transforms(const SystemContext& context);
+      void update_bounds(const SystemContext& context);
 
     public:
     explicit TransformSystem(Repository& repository, EventBus& event_bus);
-      ~TransformSystem() = default;
+      ~TransformSystem();
 
       TransformSystem(const TransformSystem&) = delete;
       TransformSystem& operator=(const TransformSystem&) = delete;
@@ -31,7 +52,7 @@ namespace gestalt::application {
 
       static glm::mat4 get_model_matrix(const TransformComponent& transform);
 
-      void update();
+      void update(const SystemContext& context);
     };
 
 }  // namespace gestalt
\ No newline at end of file
@@ -1,28 +1,66 @@
 ﻿#include "EventBus.hpp"
 
-gestalt::application::EventBus::EventBus() {
-  producer_queue_ = &queue_a_;
-  consumer_queue_ = &queue_b_;
+#include <ranges>
+
+#include <tracy/Tracy.hpp>
+
+gestalt::application::EventBus::Producer::~Producer() {
+  for (const Lane* lane = first_lane_.load(std::memory_order_acquire); lane != nullptr;) {
+    const Lane* next = lane->next;
+    delete lane;
+    lane = next;
+  }
+}
+
+void gestalt::application::EventBus::Producer::drain(EventBus& bus) const {
+  for (Lane* lane = first_lane_.load(std::memory_order_acquire); lane != nullptr;
+       lane = lane->next) {
+    lane->drain(bus);
+  }
+}
+
+gestalt::application::EventBus::Producer& gestalt::application::EventBus::producer(
+    const uint64 key) {
+  std::lock_guard lock(producers_mutex_);
+  return producers_[key];
 }
 
 void gestalt::application::EventBus::poll() {
-  std::swap(producer_queue_, consumer_queue_);
+  ZoneScopedN("EventBus::poll");
+  const auto start = std::chrono::steady_clock::now();
 
-  producer_queue_->clear();
+  {
+    std::lock_guard lock(producers_mutex_);
+    for (const auto& producer : producers_ | std::views::values) {
+      producer.drain(*this);
+    }
+  }
 
-  for (auto& event_ptr : *consumer_queue_) {
-    dispatch_event(*event_ptr);
+  coalesced_ = 0;
+  for (const auto& channel : channels_) {
+    if (channel != nullptr) {
+      coalesced_ += channel->swap();
+    }
+  }
+  total_coalesced_ += coalesced_;
+  pending_ = 0;
+
+  // channels_ may grow while subscribers run, so index instead of iterating
+  for (size_t i = 0; i < channels_.size(); ++i) {
+    if (channels_[i] != nullptr) {
+      channels_[i]->dispatch();
+    }
   }
-  consumer_queue_->clear();
-}
 
-void gestalt::application::EventBus::dispatch_event(const IEventHolder& evt_holder) {
-  const auto type_id = std::type_index(evt_holder.type());
-  const auto it = subscribers_.find(type_id);
-  if (it != subscribers_.end()) {
-    const void* event_data_ptr = evt_holder.data();
-    for (auto& func : it->second) {
-      func(event_data_ptr);
+  const std::chrono::duration<float64, std::milli> elapsed
+      = std::chrono::steady_clock::now() - start;
+  last_poll_ms_ = elapsed.count();
+
+  TracyPlot("Events/poll ms", last_poll_ms_);
+  TracyPlot("Events/coalesced", static_cast<int64_t>(coalesced_));
+  for (const auto& channel : channels_) {
+    if (channel != nullptr) {
+      TracyPlot(channel->plot_name.c_str(), static_cast<int64_t>(channel->stats.last_batch));
     }
   }
-}
\ No newline at end of file
+}
@@ -1,17 +1,119 @@
-#pragma once
+﻿#pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
-#include <type_traits>
-#include <typeindex>
-#include <unordered_map>
+#include <mutex>
+#include <new>
+#include <source_location>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "common.hpp"
+#include "TypeName.hpp"
+#include "Components/Entity.hpp"
+
 namespace gestalt::application {
 
+  namespace detail {
+    inline uint32 next_event_type_id() {
+      static std::atomic<uint32> next = 0;
+      return next.fetch_add(1, std::memory_order_relaxed);
+    }
+  }  // namespace detail
+
+  /**
+   * Dense id of an event type, assigned the first time the type is used. Ids index the channels
+   * of the EventBus directly, so no type hashing happens on emit or dispatch.
+   */
+  template <typename T> uint32 event_type_id() {
+    static const uint32 id = detail::next_event_type_id();
+    return id;
+  }
+
+  /**
+   * How events of one type that target the same entity between two polls are combined. A type
+   * opts in with a `static constexpr EventCoalescing kCoalescing` and an `Entity entity` member;
+   * kAccumulate also needs a member `void accumulate(const T& later)`. The combined event keeps
+   * the queue position of the first one.
+   */
+  enum class EventCoalescing { kNone, kLastWins, kAccumulate };
+
+  template <typename T> constexpr EventCoalescing coalescing_of() {
+    if constexpr (requires { T::kCoalescing; }) {
+      return T::kCoalescing;
+    } else {
+      return EventCoalescing::kNone;
+    }
+  }
+
+  /** Timing of one subscriber, identified by where it subscribed. */
+  struct SubscriberStats {
+    const char* file = "";
+    uint32 line = 0;
+    uint64 calls = 0;  // batches, not events
+    float64 last_ms = 0.0;
+    float64 max_ms = 0.0;
+  };
+
+  /** Counters of one event type since startup, except where noted. */
+  struct EventStats {
+    uint64 emitted = 0;     // including coalesced events
+    uint64 dispatched = 0;  // events handed to subscribers, once per event
+    uint64 coalesced = 0;
+    size_t high_water = 0;  // largest number of events dispatched by one poll
+    size_t last_batch = 0;  // events dispatched by the last poll
+    float64 last_dispatch_ms = 0.0;
+    std::span<const SubscriberStats> subscribers;
+  };
+
   class EventBus {
+    struct Lane;
+
   public:
-    EventBus();
+    /**
+     * Emits events from one thread other than the one that polls, e.g. a job, a loader thread or
+     * an audio callback. Events are appended to chunks that only this producer writes and only
+     * poll() reads, published with a release store per event, so neither side takes a lock and
+     * poll() may run while the producer emits; events published after poll() looked at the
+     * producer are delivered by the next poll.
+     */
+    class Producer {
+    public:
+      static constexpr uint32 kChunkEvents = 256;  // events per chunk of a lane
+
+      Producer() = default;
+      ~Producer();
+
+      Producer(const Producer&) = delete;
+      Producer& operator=(const Producer&) = delete;
+
+      Producer(Producer&&) = delete;
+      Producer& operator=(Producer&&) = delete;
+
+      template <typename T> void emit(const T& event_data) { lane<T>().push(event_data); }
+
+    private:
+      friend class EventBus;
+
+      template <typename T> struct TypedLane;
+
+      template <typename T> TypedLane<T>& lane();
+
+      void drain(EventBus& bus) const;
+
+      // lanes per event type, only the producer reads the vector, poll walks the list
+      std::vector<Lane*> lanes_;
+      std::atomic<Lane*> first_lane_ = nullptr;
+    };
+
+    EventBus() = default;
 
     ~EventBus() = default;
 
@@ -25,68 +127,299 @@ namespace gestalt::application {
      * Subscribe to a specific event type T.
      *
      * @param callback A function or lambda that takes (const T&) as a parameter.
+     * @param where Identifies the subscriber in the statistics.
      */
-    template <typename T> void subscribe(std::function<void(const T&)> callback) {
-      const auto type_id = std::type_index(typeid(T));
-      auto& vec = subscribers_[type_id];
-
-      std::function<void(const void*)> wrapper
-          = [cb = std::move(callback)](const void* evPtr) { cb(*static_cast<const T*>(evPtr)); };
+    template <typename T>
+    void subscribe(std::function<void(const T&)> callback,
+                   const std::source_location where = std::source_location::current()) {
+      subscribe_batch<T>(
+          [cb = std::move(callback)](const std::span<const T> events) {
+            for (const T& event : events) {
+              cb(event);
+            }
+          },
+          where);
+    }
 
-      vec.push_back(std::move(wrapper));
+    /**
+     * Subscribe to all events of type T of one poll at once.
+     *
+     * @param callback A function or lambda that takes (std::span<const T>) as a parameter.
+     * @param where Identifies the subscriber in the statistics.
+     */
+    template <typename T>
+    void subscribe_batch(std::function<void(std::span<const T>)> callback,
+                         const std::source_location where = std::source_location::current()) {
+      auto& typed_channel = channel<T>();
+      typed_channel.subscribers.push_back(std::move(callback));
+      typed_channel.subscriber_stats.push_back({where.file_name(), where.line()});
     }
 
     /**
-     * Emit an event of type T. Thread-safe in the sense that
-     * it only modifies the producer queue, not the consumer queue.
+     * Emit an event of type T. The event is copied into the queue of its type, which keeps its
+     * capacity between polls, so emitting does not allocate once the queue has grown to the
+     * usual number of events per frame.
      */
     template <typename T> void emit(const T& event_data) {
-      auto ptr = std::make_unique<EventHolder<T>>(event_data);
-      producer_queue_->push_back(std::move(ptr));
+      if (channel<T>().push(event_data)) {
+        ++pending_;
+      }
     }
 
+    /**
+     * Returns the producer for key. Thread-safe and only locks to look the key up, callers keep the
+     * reference, it stays valid as long as the bus. Each producer must only be emitted into by one
+     * thread at a time. poll() delivers producer events after the events emitted directly on the
+     * polling thread, producers in ascending key order and each producer's events in the order it
+     * emitted them, so the order does not depend on thread timing.
+     */
+    [[nodiscard]] Producer& producer(uint64 key);
+
     /**
      * Poll/Dispatch events to subscribers.
-     * Swap the producer and consumer queues so we can safely
-     * process all events that were emitted during the last frame/update.
+     * Swaps the producer and consumer queue of every type, so events emitted by subscribers are
+     * delivered by the next poll. Types are dispatched one after another in the order they were
+     * first used, each type's events in the order they were emitted.
      */
     void poll();
 
+    /** Number of events emitted on the polling thread since the last poll, after coalescing. */
+    [[nodiscard]] size_t pending_events() const { return pending_; }
+
+    /** Number of events merged into earlier ones for the last poll and since startup. */
+    [[nodiscard]] size_t coalesced_events() const { return coalesced_; }
+    [[nodiscard]] uint64 total_coalesced_events() const { return total_coalesced_; }
+
+    /** Time the last poll took, including draining producers and all subscribers. */
+    [[nodiscard]] float64 last_poll_ms() const { return last_poll_ms_; }
+
+    /**
+     * Calls fn(uint32 id, std::string_view name, const EventStats&) for every event type in the
+     * order the types were first used. Must run on the polling thread.
+     */
+    template <typename Fn> void for_each_channel(Fn&& fn) const {
+      for (uint32 id = 0; id < channels_.size(); ++id) {
+        if (const Channel* channel = channels_[id].get(); channel != nullptr) {
+          EventStats stats = channel->stats;
+          stats.subscribers = channel->subscriber_stats;
+          fn(id, channel->name, stats);
+        }
+      }
+    }
+
   private:
     /**
-     * Base class to allow storing any event type polymorphically.
+     * Events of one type of one producer, a single-producer single-consumer queue of fixed size
+     * chunks. Consumed chunks go back to the producer through a free list, so a producer that
+     * emits about the same number of events every frame stops allocating.
      */
-    struct IEventHolder {
-      virtual ~IEventHolder() = default;
-      [[nodiscard]] virtual const std::type_info& type() const = 0;
-      [[nodiscard]] virtual const void* data() const = 0;
+    struct Lane {
+      virtual ~Lane() = default;
+      virtual void drain(EventBus& bus) = 0;
+      Lane* next = nullptr;
+    };
+
+    struct Channel {
+      std::string_view name;
+      std::string plot_name;  // null-terminated and stable, as Tracy plots require
+      EventStats stats;
+      std::vector<SubscriberStats> subscriber_stats;  // parallel to the typed subscribers
+
+      virtual ~Channel() = default;
+      /** Returns how many events were coalesced into the batch that becomes dispatchable. */
+      virtual size_t swap() = 0;
+      virtual void dispatch() = 0;
     };
 
     /**
-     * Templated derived class that holds an event of type T.
+     * Events of one type, double-buffered in contiguous arrays that are reused every poll.
      */
-    template <typename T> struct EventHolder : public IEventHolder {
-      T event_data;
+    template <typename T> struct TypedChannel final : Channel {
+      std::vector<T> producer;
+      std::vector<T> consumer;
+      std::vector<std::function<void(std::span<const T>)>> subscribers;
 
-      explicit EventHolder(const T& data) : event_data(data) {}
+      // coalescing types only: producer position per entity index, validated against the event
+      // found there, so it never needs to be cleared
+      std::vector<uint32> positions;
+      size_t coalesced = 0;
 
-      [[nodiscard]] const std::type_info& type() const override { return typeid(T); }
+      /** Returns false if the event was merged into a pending one. */
+      bool push(const T& event) {
+        constexpr EventCoalescing kCoalescing = coalescing_of<T>();
+        if constexpr (kCoalescing != EventCoalescing::kNone) {
+          if (event.entity == invalid_entity) {
+            producer.push_back(event);
+            return true;
+          }
+          const uint32 index = entity_index(event.entity);
+          if (index >= positions.size()) {
+            positions.resize(index + 1, 0);
+          }
+          const uint32 position = positions[index];
+          if (position < producer.size() && producer[position].entity == event.entity) {
+            if constexpr (kCoalescing == EventCoalescing::kLastWins) {
+              producer[position] = event;
+            } else {
+              producer[position].accumulate(event);
+            }
+            ++coalesced;
+            return false;
+          }
+          positions[index] = static_cast<uint32>(producer.size());
+        }
+        producer.push_back(event);
+        return true;
+      }
 
-      [[nodiscard]] const void* data() const override { return &event_data; }
+      size_t swap() override {
+        std::swap(producer, consumer);
+        stats.emitted += consumer.size() + coalesced;
+        stats.coalesced += coalesced;
+        stats.last_batch = consumer.size();
+        stats.high_water = std::max(stats.high_water, consumer.size());
+        return std::exchange(coalesced, 0);
+      }
+
+      void dispatch() override {
+        stats.last_dispatch_ms = 0.0;
+        if (consumer.empty()) {
+          return;
+        }
+        // subscribers may subscribe more, so index instead of iterating
+        for (size_t i = 0; i < subscribers.size(); ++i) {
+          const auto start = std::chrono::steady_clock::now();
+          subscribers[i](consumer);
+          const std::chrono::duration<float64, std::milli> elapsed
+              = std::chrono::steady_clock::now() - start;
+
+          SubscriberStats& subscriber = subscriber_stats[i];
+          ++subscriber.calls;
+          subscriber.last_ms = elapsed.count();
+          subscriber.max_ms = std::max(subscriber.max_ms, subscriber.last_ms);
+          stats.last_dispatch_ms += subscriber.last_ms;
+        }
+        stats.dispatched += consumer.size();
+        consumer.clear();
+      }
     };
 
-    /**
-     * Dispatch a single event pointer to all subscribers
-     * who listen for this event type.
-     */
-    void dispatch_event(const IEventHolder& evt_holder);
+    template <typename T> TypedChannel<T>& channel() {
+      const uint32 id = event_type_id<T>();
+      if (id >= channels_.size()) {
+        channels_.resize(id + 1);
+      }
+      if (channels_[id] == nullptr) {
+        channels_[id] = std::make_unique<TypedChannel<T>>();
+        channels_[id]->name = type_name<T>();
+        channels_[id]->plot_name = "Events/" + std::string(type_name<T>());
+      }
+      return static_cast<TypedChannel<T>&>(*channels_[id]);
+    }
+
+    std::vector<std::unique_ptr<Channel>> channels_;  // indexed by event_type_id
+    std::mutex producers_mutex_;
+    std::map<uint64, Producer> producers_;  // nodes, so handed out producers stay in place
+    size_t pending_ = 0;
+    size_t coalesced_ = 0;
+    uint64 total_coalesced_ = 0;
+    float64 last_poll_ms_ = 0.0;
+  };
 
-    std::unordered_map<std::type_index, std::vector<std::function<void(const void*)>>> subscribers_;
+  template <typename T> struct EventBus::Producer::TypedLane final : Lane {
+    struct Chunk {
+      std::atomic<uint32> published = 0;
+      std::atomic<Chunk*> next = nullptr;
+      Chunk* next_free = nullptr;
+      alignas(T) std::byte storage[kChunkEvents * sizeof(T)];
 
-    std::vector<std::unique_ptr<IEventHolder>> queue_a_;
-    std::vector<std::unique_ptr<IEventHolder>> queue_b_;
-    std::vector<std::unique_ptr<IEventHolder>>* producer_queue_;
-    std::vector<std::unique_ptr<IEventHolder>>* consumer_queue_;
+      T* events() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    // producer side
+    Chunk* tail = new Chunk;
+    // consumer side
+    Chunk* head = tail;
+    uint32 consumed = 0;
+    // pushed by the consumer, popped by the producer, one of each keeps it free of ABA
+    std::atomic<Chunk*> free_chunks = nullptr;
+
+    ~TypedLane() override {
+      for (Chunk* chunk = head; chunk != nullptr;) {
+        Chunk* next_chunk = chunk->next.load(std::memory_order_acquire);
+        const uint32 end = chunk->published.load(std::memory_order_acquire);
+        for (uint32 i = chunk == head ? consumed : 0; i < end; ++i) {
+          chunk->events()[i].~T();
+        }
+        delete chunk;
+        chunk = next_chunk;
+      }
+      for (Chunk* chunk = free_chunks.load(std::memory_order_acquire); chunk != nullptr;) {
+        Chunk* next_chunk = chunk->next_free;
+        delete chunk;
+        chunk = next_chunk;
+      }
+    }
+
+    void push(const T& event) {
+      uint32 count = tail->published.load(std::memory_order_relaxed);
+      if (count == kChunkEvents) {
+        Chunk* chunk = free_chunks.load(std::memory_order_acquire);
+        while (chunk != nullptr
+               && !free_chunks.compare_exchange_weak(chunk, chunk->next_free,
+                                                     std::memory_order_acquire)) {
+        }
+        if (chunk == nullptr) {
+          chunk = new Chunk;
+        } else {
+          chunk->published.store(0, std::memory_order_relaxed);
+          chunk->next.store(nullptr, std::memory_order_relaxed);
+        }
+        tail->next.store(chunk, std::memory_order_release);
+        tail = chunk;
+        count = 0;
+      }
+      new (&tail->events()[count]) T(event);
+      tail->published.store(count + 1, std::memory_order_release);
+    }
+
+    void drain(EventBus& bus) override {
+      while (true) {
+        const uint32 end = head->published.load(std::memory_order_acquire);
+        for (; consumed < end; ++consumed) {
+          T& event = head->events()[consumed];
+          bus.emit(event);
+          event.~T();
+        }
+        Chunk* next_chunk
+            = end == kChunkEvents ? head->next.load(std::memory_order_acquire) : nullptr;
+        if (next_chunk == nullptr) {
+          return;
+        }
+        Chunk* done = head;
+        head = next_chunk;
+        consumed = 0;
+        done->next_free = free_chunks.load(std::memory_order_relaxed);
+        while (!free_chunks.compare_exchange_weak(done->next_free, done,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+        }
+      }
+    }
   };
 
-}  // namespace gestalt::application
\ No newline at end of file
+  template <typename T> EventBus::Producer::TypedLane<T>& EventBus::Producer::lane() {
+    const uint32 id = event_type_id<T>();
+    if (id >= lanes_.size()) {
+      lanes_.resize(id + 1, nullptr);
+    }
+    if (lanes_[id] == nullptr) {
+      auto* lane = new TypedLane<T>;
+      lane->next = first_lane_.load(std::memory_order_relaxed);
+      first_lane_.store(lane, std::memory_order_release);
+      lanes_[id] = lane;
+    }
+    return static_cast<TypedLane<T>&>(*lanes_[id]);
+  }
+
+}  // namespace gestalt::application
@@ -1,35 +1,60 @@
-#pragma once
+﻿#pragma once
 #include "Components/Entity.hpp"
-#include "glm/fwd.hpp"
+#include "Events/EventBus.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/vec3.hpp"
 
 namespace gestalt::application {
 
-  struct MoveEntityEvent {
-    MoveEntityEvent(Entity entity, glm::vec3 new_position, glm::quat new_rotation, float32 new_scale)
-        : entity(entity), new_position(new_position), new_rotation(new_rotation), new_scale(new_scale) {}
-    Entity entity;
-    glm::vec3 new_position;
-    glm::quat new_rotation;
-    glm::vec3 new_scale;
-  };
+  /**
+   * Sets some fields of the local transform of an entity. Moves, translations, rotations and
+   * scales share this one type, so all transform changes of an entity between two polls merge
+   * into a single event, later fields replacing earlier ones in the order they were emitted.
+   */
+  struct TransformEntityEvent {
+    static constexpr EventCoalescing kCoalescing = EventCoalescing::kAccumulate;
 
-  struct TranslateEntityEvent {
-    TranslateEntityEvent(Entity entity, glm::vec3 new_position)
-        : entity(entity), new_position(new_position) {}
-    Entity entity;
-    glm::vec3 new_position;
-  };
+    enum Field : uint8 { kPosition = 1 << 0, kRotation = 1 << 1, kScale = 1 << 2 };
 
-  struct RotateEntityEvent {
-    RotateEntityEvent(Entity entity, glm::quat new_rotation)
-        : entity(entity), new_rotation(new_rotation) {}
-    Entity entity;
-    glm::quat new_rotation;
-  };
+    TransformEntityEvent(Entity entity, uint8 fields, glm::vec3 new_position,
+                         glm::quat new_rotation, float32 new_scale)
+        : entity(entity),
+          fields(fields),
+          new_position(new_position),
+          new_rotation(new_rotation),
+          new_scale(new_scale) {}
+
+    static TransformEntityEvent move(Entity entity, glm::vec3 new_position, glm::quat new_rotation,
+                                     float32 new_scale) {
+      return {entity, kPosition | kRotation | kScale, new_position, new_rotation, new_scale};
+    }
+    static TransformEntityEvent translate(Entity entity, glm::vec3 new_position) {
+      return {entity, kPosition, new_position, glm::quat(1.f, 0.f, 0.f, 0.f), 1.f};
+    }
+    static TransformEntityEvent rotate(Entity entity, glm::quat new_rotation) {
+      return {entity, kRotation, glm::vec3(0.f), new_rotation, 1.f};
+    }
+    static TransformEntityEvent rescale(Entity entity, float32 new_scale) {
+      return {entity, kScale, glm::vec3(0.f), glm::quat(1.f, 0.f, 0.f, 0.f), new_scale};
+    }
+
+    void accumulate(const TransformEntityEvent& later) {
+      if (later.fields & kPosition) {
+        new_position = later.new_position;
+      }
+      if (later.fields & kRotation) {
+        new_rotation = later.new_rotation;
+      }
+      if (later.fields & kScale) {
+        new_scale = later.new_scale;
+      }
+      fields |= later.fields;
+    }
 
-  struct ScaleEntityEvent {
-    ScaleEntityEvent(Entity entity, float32 new_scale) : entity(entity), new_scale(new_scale) {}
     Entity entity;
+    uint8 fields;  // Field bits, only the flagged members are applied
+    glm::vec3 new_position;
+    glm::quat new_rotation;
     float32 new_scale;
   };
 
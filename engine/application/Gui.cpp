@@ -187,10 +187,7 @@ namespace gestalt::application {
         glm::mat4 localTransform = glm::translate(glm::mat4(1.0f), transform->position())
                                    * glm::toMat4(transform->rotation())
                                    * glm::scale(glm::mat4(1.0f), transform->scale());
-        glm::mat4 parentWorldTransform
-            = glm::translate(glm::mat4(1.0f), transform->parent_position)
-              * glm::toMat4(transform->parent_rotation)
-              * glm::scale(glm::mat4(1.0f), glm::vec3(transform->parent_scale));
+        glm::mat4 parentWorldTransform = parent_world_matrix(selected_entity_);
         glm::mat4 inverseParentWorldTransform = glm::inverse(parentWorldTransform);
         glm::mat4 worldTransform = parentWorldTransform * localTransform;
 
@@ -211,10 +208,8 @@ namespace gestalt::application {
             const auto new_pos
                 = glm::vec3(inverseParentWorldTransform
                             * glm::vec4(translation[0], translation[1], translation[2], 1.0f));
-            event_bus_.emit<TranslateEntityEvent>(
-                TranslateEntityEvent{selected_entity_, new_pos});
-
-            transform->is_dirty = true;
+            event_bus_.emit<TransformEntityEvent>(
+                TransformEntityEvent::translate(selected_entity_, new_pos));
           }
         } else if (guizmo_operation_ == 1) {
           if (Manipulate(view, projection, ImGuizmo::TRANSLATE, ImGuizmo::LOCAL, model)) {
@@ -222,14 +217,12 @@ namespace gestalt::application {
 
             // TODO transform.rotation = glm::quat(rotation[3], rotation[0], rotation[1],
             // rotation[2]);
-            transform->is_dirty = true;
           }
         } else {
           if (Manipulate(view, projection, ImGuizmo::SCALE, ImGuizmo::LOCAL, model)) {
             ImGuizmo::DecomposeMatrixToComponents(model, translation, rotation, scale);
 
             //transform->scale = std::max({scale[0], scale[1], scale[2]});
-            transform->is_dirty = true;
           }
         }
       }
@@ -341,6 +334,8 @@ namespace gestalt::application {
         if (ImGui::BeginMenu("Window")) {
           ImGui::MenuItem("Scene Graph", nullptr, &show_scene_hierarchy_);
           ImGui::MenuItem("Guizmo", nullptr, &show_guizmo_);
+          ImGui::MenuItem("Component Storages", nullptr, &show_component_storages_);
+          ImGui::MenuItem("Event Bus", nullptr, &show_event_bus_);
 
           if (ImGui::BeginMenu("Settings")) {
             ImGui::MenuItem("Shading", nullptr, &show_shading_settings);
@@ -466,38 +461,38 @@ namespace gestalt::application {
     void Gui::lights() {
       if (ImGui::Begin("Lights")) {
         if (ImGui::CollapsingHeader("Directional Lights", ImGuiTreeNodeFlags_DefaultOpen)) {
-          auto lights = repository_.directional_light_components.snapshot();
+          const auto& lights = repository_.directional_light_components;
           int selectedLightIndex = 0;  // Default to the first light
           if (!lights.empty()) {
             ImGui::SliderInt("Select Light", &selectedLightIndex, 0, lights.size() - 1);
-            auto& [entity, light_component] = lights[selectedLightIndex];
+            const Entity entity = lights.entities()[selectedLightIndex];
             selected_entity_ = entity;
             const auto transform_component = repository_.transform_components.find(entity);
-            show_directional_light_component(&light_component, transform_component);
+            show_directional_light_component(&lights.components()[selectedLightIndex], transform_component);
           }
         }
 
         if (ImGui::CollapsingHeader("Point Lights", ImGuiTreeNodeFlags_DefaultOpen)) {
-          auto lights = repository_.point_light_components.snapshot();
+          const auto& lights = repository_.point_light_components;
           int selectedLightIndex = 0;  // Default to the first light
           if (!lights.empty()) {
             ImGui::SliderInt("Select Light", &selectedLightIndex, 0, lights.size() - 1);
-            auto& [entity, light_component] = lights[selectedLightIndex];
+            const Entity entity = lights.entities()[selectedLightIndex];
             selected_entity_ = entity;
             const auto transform_component = repository_.transform_components.find(entity);
-            show_point_light_component(&light_component, transform_component);
+            show_point_light_component(&lights.components()[selectedLightIndex], transform_component);
           }
         }
 
         if (ImGui::CollapsingHeader("Spot Lights", ImGuiTreeNodeFlags_DefaultOpen)) {
-          auto lights = repository_.spot_light_components.snapshot();
+          const auto& lights = repository_.spot_light_components;
           int selectedLightIndex = 0;  // Default to the first light
           if (!lights.empty()) {
             ImGui::SliderInt("Select Light", &selectedLightIndex, 0, lights.size() - 1);
-            auto& [entity, light_component] = lights[selectedLightIndex];
+            const Entity entity = lights.entities()[selectedLightIndex];
             selected_entity_ = entity;
             const auto transform_component = repository_.transform_components.find(entity);
-            show_spotlight_component(&light_component, transform_component);
+            show_spotlight_component(&lights.components()[selectedLightIndex], transform_component);
           }
         }
         ImGui::End();
@@ -508,15 +503,16 @@ namespace gestalt::application {
       if (ImGui::Begin("Cameras")) {
 
         if (ImGui::CollapsingHeader("Animation Cameras", ImGuiTreeNodeFlags_DefaultOpen)) {
-          auto cameras = repository_.animation_camera_components.snapshot();
+          const auto& cameras = repository_.animation_camera_components;
 
           static int selectedCameraIndex = 0;
           if (!cameras.empty()) {
+            selectedCameraIndex = std::min<int>(selectedCameraIndex, cameras.size() - 1);
             ImGui::SliderInt("Select Camera", &selectedCameraIndex, 0, cameras.size() - 1);
 
-            auto& [entity, camera_component] = cameras[selectedCameraIndex];
+            const Entity entity = cameras.entities()[selectedCameraIndex];
 
-            show_camera_component(&camera_component);
+            show_camera_component(&cameras.components()[selectedCameraIndex]);
             ImGui::Separator();
             if (ImGui::Button("Set as Active Camera")) {
               actions_.set_active_camera(entity);
@@ -525,15 +521,16 @@ namespace gestalt::application {
         }
 
         if (ImGui::CollapsingHeader("First Person Cameras", ImGuiTreeNodeFlags_DefaultOpen)) {
-          auto cameras = repository_.first_person_camera_components.snapshot();
+          const auto& cameras = repository_.first_person_camera_components;
 
           static int selectedCameraIndex = 0;
           if (!cameras.empty()) {
+            selectedCameraIndex = std::min<int>(selectedCameraIndex, cameras.size() - 1);
             ImGui::SliderInt("Select Camera", &selectedCameraIndex, 0, cameras.size() - 1);
 
-            auto& [entity, camera_component] = cameras[selectedCameraIndex];
+            const Entity entity = cameras.entities()[selectedCameraIndex];
 
-            show_camera_component(&camera_component);
+            show_camera_component(&cameras.components()[selectedCameraIndex]);
             ImGui::Separator();
             if (ImGui::Button("Set as Active Camera")) {
               actions_.set_active_camera(entity);
@@ -542,15 +539,16 @@ namespace gestalt::application {
         }
 
         if (ImGui::CollapsingHeader("Free Fly Cameras", ImGuiTreeNodeFlags_DefaultOpen)) {
-          auto cameras = repository_.free_fly_camera_components.snapshot();
+          const auto& cameras = repository_.free_fly_camera_components;
 
           static int selectedCameraIndex = 0;
           if (!cameras.empty()) {
+            selectedCameraIndex = std::min<int>(selectedCameraIndex, cameras.size() - 1);
             ImGui::SliderInt("Select Camera", &selectedCameraIndex, 0, cameras.size() - 1);
 
-            auto& [entity, camera_component] = cameras[selectedCameraIndex];
+            const Entity entity = cameras.entities()[selectedCameraIndex];
 
-            show_camera_component(&camera_component);
+            show_camera_component(&cameras.components()[selectedCameraIndex]);
             ImGui::Separator();
             if (ImGui::Button("Set as Active Camera")) {
               actions_.set_active_camera(entity);
@@ -559,15 +557,16 @@ namespace gestalt::application {
         }
 
         if (ImGui::CollapsingHeader("Orbit Cameras", ImGuiTreeNodeFlags_DefaultOpen)) {
-          auto cameras = repository_.orbit_camera_components.snapshot();
+          const auto& cameras = repository_.orbit_camera_components;
 
           static int selectedCameraIndex = 0;
           if (!cameras.empty()) {
+            selectedCameraIndex = std::min<int>(selectedCameraIndex, cameras.size() - 1);
             ImGui::SliderInt("Select Camera", &selectedCameraIndex, 0, cameras.size() - 1);
 
-            auto& [entity, camera_component] = cameras[selectedCameraIndex];
+            const Entity entity = cameras.entities()[selectedCameraIndex];
 
-            show_camera_component(&camera_component);
+            show_camera_component(&cameras.components()[selectedCameraIndex]);
             ImGui::Separator();
             if (ImGui::Button("Set as Active Camera")) {
               actions_.set_active_camera(entity);
@@ -596,6 +595,97 @@ namespace gestalt::application {
       ImGui::End();
     }
 
+    void Gui::component_storages() {
+      if (ImGui::Begin("Component Storages", &show_component_storages_)) {
+        if (ImGui::BeginTable("storages", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+          ImGui::TableSetupColumn("Component");
+          ImGui::TableSetupColumn("Count");
+          ImGui::TableSetupColumn("KiB");
+          ImGui::TableSetupColumn("Churn");
+          ImGui::TableHeadersRow();
+
+          repository_.components.for_each_storage(
+              [](uint32, const std::string_view name, const StorageStats& stats) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(name.data(), name.data() + name.size());
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", stats.count);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", static_cast<double>(stats.bytes) / 1024.0);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(stats.churn));
+              });
+          ImGui::EndTable();
+        }
+      }
+      ImGui::End();
+    }
+
+    void Gui::event_bus() {
+      if (ImGui::Begin("Event Bus", &show_event_bus_)) {
+        ImGui::Text("Last poll: %.3f ms, %zu coalesced", event_bus_.last_poll_ms(),
+                    event_bus_.coalesced_events());
+
+        if (ImGui::BeginTable("events", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+          ImGui::TableSetupColumn("Event / Subscriber");
+          ImGui::TableSetupColumn("Emitted");
+          ImGui::TableSetupColumn("Dispatched");
+          ImGui::TableSetupColumn("Coalesced");
+          ImGui::TableSetupColumn("High Water");
+          ImGui::TableSetupColumn("Last ms");
+          ImGui::TableSetupColumn("Max ms");
+          ImGui::TableHeadersRow();
+
+          event_bus_.for_each_channel([](const uint32 id, const std::string_view name,
+                                         const EventStats& stats) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            const bool open = ImGui::TreeNodeEx(reinterpret_cast<void*>(static_cast<uintptr_t>(id)),
+                                                ImGuiTreeNodeFlags_SpanFullWidth,
+                                                "%.*s", static_cast<int>(name.size()),
+                                                name.data());
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(stats.emitted));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(stats.dispatched));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(stats.coalesced));
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", stats.high_water);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.last_dispatch_ms);
+            ImGui::TableNextColumn();
+
+            if (!open) {
+              return;
+            }
+            for (const SubscriberStats& subscriber : stats.subscribers) {
+              std::string_view file = subscriber.file;
+              file.remove_prefix(file.find_last_of("/\\") + 1);
+              ImGui::TableNextRow();
+              ImGui::TableNextColumn();
+              ImGui::Indent();
+              ImGui::Text("%.*s:%u", static_cast<int>(file.size()), file.data(), subscriber.line);
+              ImGui::Unindent();
+              ImGui::TableNextColumn();
+              ImGui::TableNextColumn();
+              ImGui::Text("%llu", static_cast<unsigned long long>(subscriber.calls));
+              ImGui::TableNextColumn();
+              ImGui::TableNextColumn();
+              ImGui::TableNextColumn();
+              ImGui::Text("%.3f", subscriber.last_ms);
+              ImGui::TableNextColumn();
+              ImGui::Text("%.3f", subscriber.max_ms);
+            }
+            ImGui::TreePop();
+          });
+          ImGui::EndTable();
+        }
+      }
+      ImGui::End();
+    }
+
     void Gui::new_frame() {
       ImGuizmo::SetImGuiContext(ImGui::GetCurrentContext());
 
@@ -617,6 +707,14 @@ namespace gestalt::application {
         lights();
       }
 
+      if (show_component_storages_) {
+        component_storages();
+      }
+
+      if (show_event_bus_) {
+        event_bus();
+      }
+
       if (show_cameras_) {
         cameras();
       }
@@ -923,7 +1021,7 @@ namespace gestalt::application {
         ImGuiTreeNodeFlags node_flags = ImGuiTreeNodeFlags_OpenOnArrow;
 
         // If the node has no children, make it a leaf node
-        if (node->children.empty()) {
+        if (node->first_child == invalid_entity) {
           node_flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
         }
 
@@ -937,7 +1035,10 @@ namespace gestalt::application {
         // Start a horizontal group to align the tree node and the checkbox
         ImGui::BeginGroup();
 
-        bool node_open = ImGui::TreeNodeEx(node->name.c_str(), node_flags);
+        const char* name = repository_.names.c_str(node->name);
+        bool node_open = *name != '\0'
+                             ? ImGui::TreeNodeEx(name, node_flags)
+                             : ImGui::TreeNodeEx("##unnamed", node_flags, "entity_%u", entity);
 
         // If the tree node is open, we need a way to click the node itself, not just the arrow
         if (ImGui::IsItemClicked()) {
@@ -952,7 +1053,10 @@ namespace gestalt::application {
 
         // Move cursor and render checkbox
         ImGui::SameLine(offset);
-        ImGui::Checkbox("##visible", &node->visible);  // ## to hide label but keep unique ID
+        bool visible = !repository_.hidden_components.contains(entity);
+        if (ImGui::Checkbox("##visible", &visible)) {  // ## to hide label but keep unique ID
+          repository_.hidden_components.set(entity, !visible);
+        }
 
         ImGui::EndGroup();
 
@@ -965,64 +1069,76 @@ namespace gestalt::application {
         }
 
         // Recursively display children if the node is open
-        if (node_open && !node->children.empty()) {
-          for (const auto child_entity : node->children) {
+        if (node_open && node->first_child != invalid_entity) {
+          for (Entity child_entity = node->first_child; child_entity != invalid_entity;) {
             display_scene_hierarchy(child_entity);
+            const auto child_node = repository_.scene_graph.find(child_entity);
+            child_entity = child_node != nullptr ? child_node->next_sibling : invalid_entity;
           }
           ImGui::TreePop();
         }
       }
     }
 
+    glm::mat4 Gui::parent_world_matrix(const Entity entity) const {
+      const auto node = repository_.scene_graph.find(entity);
+      if (node == nullptr) {
+        return glm::mat4(1.0f);
+      }
+      const auto parent_world = repository_.scene_hierarchy.world_transform(node->parent);
+      return parent_world != nullptr ? parent_world->matrix : glm::mat4(1.0f);
+    }
+
     void Gui::show_transform_component(const NodeComponent* node, const TransformComponent* transform) {
       ImGui::Text("Local Transform:");
 
       // Local position control
       auto position = transform->position();
       if (ImGui::DragFloat3("Local Position", &position.x, 0.1f)) {
-        event_bus_.emit<TranslateEntityEvent>(TranslateEntityEvent{selected_entity_, position});
+        event_bus_.emit<TransformEntityEvent>(
+            TransformEntityEvent::translate(selected_entity_, position));
       }
 
       // Local rotation controls
       glm::vec3 euler = glm::degrees(eulerAngles(transform->rotation()));
       if (ImGui::DragFloat("Local X Rotation", &euler.x, 1.0f)) {
-        event_bus_.emit<RotateEntityEvent>(
-            RotateEntityEvent{selected_entity_, glm::quat(radians(euler))});
+        event_bus_.emit<TransformEntityEvent>(
+            TransformEntityEvent::rotate(selected_entity_, glm::quat(radians(euler))));
       }
       if (ImGui::DragFloat("Local Y Rotation", &euler.y, 1.0f)) {
-        event_bus_.emit<RotateEntityEvent>(
-            RotateEntityEvent{selected_entity_, glm::quat(radians(euler))});
+        event_bus_.emit<TransformEntityEvent>(
+            TransformEntityEvent::rotate(selected_entity_, glm::quat(radians(euler))));
       }
       if (ImGui::DragFloat("Local Z Rotation", &euler.z, 1.0f)) {
-        event_bus_.emit<RotateEntityEvent>(
-            RotateEntityEvent{selected_entity_, glm::quat(radians(euler))});
+        event_bus_.emit<TransformEntityEvent>(
+            TransformEntityEvent::rotate(selected_entity_, glm::quat(radians(euler))));
       }
 
       // Local scale control
       float local_scale = transform->scale_uniform();
       if (ImGui::DragFloat("Local Scale", &local_scale, 0.005f)) {
-        event_bus_.emit<ScaleEntityEvent>(ScaleEntityEvent{selected_entity_, local_scale});
+        event_bus_.emit<TransformEntityEvent>(
+            TransformEntityEvent::rescale(selected_entity_, local_scale));
       }
 
       ImGui::Separator();
       ImGui::Text("World Transform:");
 
-      glm::mat4 localTransform = translate(glm::mat4(1.0f), transform->position())
-                                 * toMat4(transform->rotation())
-                                 * scale(glm::mat4(1.0f), transform->scale());
-      glm::mat4 parentWorldTransform
-          = translate(glm::mat4(1.0f), transform->parent_position)
-            * toMat4(transform->parent_rotation)
-            * scale(glm::mat4(1.0f), glm::vec3(transform->parent_scale));
+      const auto world = repository_.scene_hierarchy.world_transform(selected_entity_);
+      if (world == nullptr) {
+        return;
+      }
+      glm::mat4 parentWorldTransform = parent_world_matrix(selected_entity_);
       glm::mat4 inverseParentWorldTransform = inverse(parentWorldTransform);
-      glm::mat4 worldTransform = parentWorldTransform * localTransform;
+      const glm::mat4& worldTransform = world->matrix;
 
       // World position control (taking parent transform into account)
       glm::vec3 world_position = glm::vec3(worldTransform[3]);
       if (ImGui::DragFloat3("World Position", &world_position.x, 0.1f)) {
         auto new_pos
             = glm::vec3(inverseParentWorldTransform * glm::vec4(world_position, 1.0f));
-        event_bus_.emit<TranslateEntityEvent>(TranslateEntityEvent{selected_entity_, new_pos});
+        event_bus_.emit<TransformEntityEvent>(
+            TransformEntityEvent::translate(selected_entity_, new_pos));
       }
 
       // World rotation controls (taking parent transform into account)
@@ -1030,24 +1146,28 @@ namespace gestalt::application {
       if (ImGui::DragFloat("World X Rotation", &world_euler.x, 1.0f)) {
         auto new_rot = normalize(
             quat_cast(inverseParentWorldTransform * toMat4(glm::quat(radians(world_euler)))));
-        event_bus_.emit<RotateEntityEvent>(RotateEntityEvent{selected_entity_, new_rot});
+        event_bus_.emit<TransformEntityEvent>(
+            TransformEntityEvent::rotate(selected_entity_, new_rot));
       }
       if (ImGui::DragFloat("World Y Rotation", &world_euler.y, 1.0f)) {
         auto new_rot = normalize(
             quat_cast(inverseParentWorldTransform * toMat4(glm::quat(radians(world_euler)))));
-        event_bus_.emit<RotateEntityEvent>(RotateEntityEvent{selected_entity_, new_rot});
+        event_bus_.emit<TransformEntityEvent>(
+            TransformEntityEvent::rotate(selected_entity_, new_rot));
       }
       if (ImGui::DragFloat("World Z Rotation", &world_euler.z, 1.0f)) {
         auto new_rot = normalize(
             quat_cast(inverseParentWorldTransform * toMat4(glm::quat(radians(world_euler)))));
-        event_bus_.emit<RotateEntityEvent>(RotateEntityEvent{selected_entity_, new_rot});
+        event_bus_.emit<TransformEntityEvent>(
+            TransformEntityEvent::rotate(selected_entity_, new_rot));
       }
 
       // World scale control (taking parent transform into account)
       float world_scale = length(glm::vec3(worldTransform[0]));
       if (ImGui::DragFloat("World Scale", &world_scale, 0.005f)) {
-        auto new_scale = world_scale / transform->parent_scale;
-        event_bus_.emit<ScaleEntityEvent>(ScaleEntityEvent{selected_entity_, new_scale});
+        auto new_scale = world_scale / length(glm::vec3(parentWorldTransform[0]));
+        event_bus_.emit<TransformEntityEvent>(
+            TransformEntityEvent::rescale(selected_entity_, new_scale));
       }
       ImGui::Text("AABB max: (%.3f, %.3f, %.3f)", node->bounds.max.x, node->bounds.max.y,
                   node->bounds.max.z);
@@ -1192,17 +1312,15 @@ namespace gestalt::application {
       float azimuth = euler_angles.y;     // Azimuth angle (yaw)
       float elevation = -euler_angles.x;  // Elevation angle (pitch)
 
-      if (ImGui::SliderFloat("Azimuth", &azimuth, -89.f, 89.0f)) {
-        light->is_dirty = true;
-      }
-
-      if (ImGui::SliderFloat("Elevation", &elevation, 1.f, 179.f)) {
-        light->is_dirty = true;
-      }
+      bool rotation_changed = ImGui::SliderFloat("Azimuth", &azimuth, -89.f, 89.0f);
+      rotation_changed |= ImGui::SliderFloat("Elevation", &elevation, 1.f, 179.f);
 
       // Update rotation quaternion based on user input
-      auto new_rot = glm::quat(glm::radians(glm::vec3(-elevation, azimuth, 0.0f)));
-      event_bus_.emit<RotateEntityEvent>({selected_entity_, new_rot});
+      if (rotation_changed) {
+        auto new_rot = glm::quat(glm::radians(glm::vec3(-elevation, azimuth, 0.0f)));
+        event_bus_.emit<TransformEntityEvent>(
+            TransformEntityEvent::rotate(selected_entity_, new_rot));
+      }
     }
 
     void Gui::show_point_light_component(const PointLightComponent* light,
@@ -1227,7 +1345,8 @@ namespace gestalt::application {
 
       auto position = transform->position();
       if (ImGui::DragFloat3("Position", &position.x, 0.1f)) {
-        event_bus_.emit<TranslateEntityEvent>({selected_entity_, position});
+        event_bus_.emit<TransformEntityEvent>(
+            TransformEntityEvent::translate(selected_entity_, position));
       }
     }
 
@@ -1256,17 +1375,12 @@ namespace gestalt::application {
 
       // Draw sliders in degrees
       ImGui::Text("Spotlight Angles (deg)");
-      if (ImGui::SliderFloat("Inner Angle", &innerDeg, 0.0f, 90, "%.1f")) {
-        light->is_dirty = true;
-      }
-      if (ImGui::SliderFloat("Outer Angle", &outerDeg, 0.0f, 90, "%.1f")) {
-        light->is_dirty = true;
-      }
+      ImGui::SliderFloat("Inner Angle", &innerDeg, 0.0f, 90, "%.1f");
+      ImGui::SliderFloat("Outer Angle", &outerDeg, 0.0f, 90, "%.1f");
 
       // Enforce that the outer angle is >= inner angle
       if (outerDeg < innerDeg) {
         outerDeg = innerDeg;
-        light->is_dirty = true;
       }
 
       // Convert angles (in degrees) -> cosines (in radians)
@@ -1442,7 +1556,28 @@ namespace gestalt::application {
     void Gui::show_node_component() {
       if (selected_entity_ != invalid_entity) {
         auto selected_node = repository_.scene_graph.find(selected_entity_);
-        ImGui::Text(selected_node->name.c_str());
+        if (selected_node == nullptr) {
+          selected_entity_ = invalid_entity;  // entity was destroyed
+          return;
+        }
+        if (const char* name = repository_.names.c_str(selected_node->name); *name != '\0') {
+          ImGui::Text("%s", name);
+        } else {
+          ImGui::Text("entity_%u", selected_entity_);
+        }
+        if (selected_entity_ != root_entity) {
+          ImGui::SameLine();
+          if (ImGui::Button("Delete")) {
+            actions_.destroy_entity(selected_entity_);
+            selected_entity_ = invalid_entity;
+            return;
+          }
+
+          bool is_static = repository_.static_components.contains(selected_entity_);
+          if (ImGui::Checkbox("Static", &is_static)) {
+            actions_.get_component_factory().set_static(selected_entity_, is_static);
+          }
+        }
 
         const auto transform = repository_.transform_components.find(selected_entity_);
         if (transform != nullptr) {
@@ -24,6 +24,7 @@ namespace gestalt::application {
       std::function<RenderConfig&()> get_render_config;
       std::function<void(Entity)> set_active_camera;
       std::function<Entity()> get_active_camera;
+      std::function<void(Entity)> destroy_entity;
     };
 
     class Gui{
@@ -49,12 +50,17 @@ namespace gestalt::application {
       bool show_lights_ = false;
       bool show_cameras_ = false;
       bool show_help_ = false;
+      bool show_component_storages_ = false;
+      bool show_event_bus_ = false;
 
       void menu_bar();
       void lights();
       void cameras();
       void scene_graph();
+      void component_storages();
+      void event_bus();
       void display_scene_hierarchy(Entity entity);
+      [[nodiscard]] glm::mat4 parent_world_matrix(Entity entity) const;
       void show_transform_component(const NodeComponent* node, const TransformComponent* transform);
       void show_mesh_component(const MeshComponent* mesh_component);
       void show_directional_light_component(const DirectionalLightComponent* light,
@@ -0,0 +1,52 @@
+﻿#include "JoltJobSystem.hpp"
+
+#include <thread>
+
+namespace gestalt::application {
+
+  JoltJobSystem::JoltJobSystem(foundation::JobSystem& job_system, const JPH::uint max_jobs,
+                               const JPH::uint max_barriers)
+      : JobSystemWithBarrier(max_barriers), job_system_(job_system) {
+    jobs_.Init(max_jobs, max_jobs);
+  }
+
+  int JoltJobSystem::GetMaxConcurrency() const {
+    return static_cast<int>(job_system_.worker_count()) + 1;
+  }
+
+  JPH::JobHandle JoltJobSystem::CreateJob(const char* inName, const JPH::ColorArg inColor,
+                                          const JobFunction& inJobFunction,
+                                          const JPH::uint32 inNumDependencies) {
+    JPH::uint32 index;
+    while ((index = jobs_.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies))
+           == decltype(jobs_)::cInvalidObjectIndex) {
+      JPH_ASSERT(false, "No jobs available!");
+      std::this_thread::yield();
+    }
+
+    Job* job = &jobs_.Get(index);
+    JobHandle handle(job);  // holds a reference until the caller is done with the job
+
+    if (inNumDependencies == 0) {
+      QueueJob(job);
+    }
+    return handle;
+  }
+
+  void JoltJobSystem::QueueJob(Job* inJob) {
+    inJob->AddRef();
+    job_system_.schedule([inJob] {
+      inJob->Execute();
+      inJob->Release();
+    });
+  }
+
+  void JoltJobSystem::QueueJobs(Job** inJobs, const JPH::uint inNumJobs) {
+    for (JPH::uint i = 0; i < inNumJobs; ++i) {
+      QueueJob(inJobs[i]);
+    }
+  }
+
+  void JoltJobSystem::FreeJob(Job* inJob) { jobs_.DestructObject(inJob); }
+
+}  // namespace gestalt::application
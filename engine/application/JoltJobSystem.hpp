@@ -0,0 +1,38 @@
+﻿#pragma once
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+
+#include "JobSystem.hpp"
+
+namespace gestalt::application {
+
+  /**
+   * @brief Runs Jolt's physics jobs on the engine job system instead of a separate thread pool.
+   */
+  class JoltJobSystem final : public JPH::JobSystemWithBarrier {
+    foundation::JobSystem& job_system_;
+    JPH::FixedSizeFreeList<Job> jobs_;
+
+  public:
+    JoltJobSystem(foundation::JobSystem& job_system, JPH::uint max_jobs, JPH::uint max_barriers);
+    ~JoltJobSystem() override = default;
+
+    JoltJobSystem(const JoltJobSystem&) = delete;
+    JoltJobSystem& operator=(const JoltJobSystem&) = delete;
+
+    JoltJobSystem(JoltJobSystem&&) = delete;
+    JoltJobSystem& operator=(JoltJobSystem&&) = delete;
+
+    int GetMaxConcurrency() const override;
+    JobHandle CreateJob(const char* inName, JPH::ColorArg inColor,
+                        const JobFunction& inJobFunction, JPH::uint32 inNumDependencies) override;
+
+  protected:
+    void QueueJob(Job* inJob) override;
+    void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+    void FreeJob(Job* inJob) override;
+  };
+
+}  // namespace gestalt::application
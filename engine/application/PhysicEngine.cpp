@@ -3,7 +3,6 @@
 #include <Jolt/Jolt.h>
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Core/Factory.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Physics/PhysicsSettings.h>
 #include <Jolt/Physics/PhysicsSystem.h>
@@ -19,8 +18,8 @@
 
 #include <cstdarg>
 #include <iostream>
-#include <thread>
 
+#include "JoltJobSystem.hpp"
 #include "PhysicUtil.hpp"
 #include "Components/PhysicsComponent.hpp"
 
@@ -144,13 +143,13 @@ namespace gestalt::application {
     }
   };
 
-  void PhysicEngine::init() {
+  void PhysicEngine::init(foundation::JobSystem& engine_job_system) {
     JPH::RegisterDefaultAllocator();
     JPH::Factory::sInstance = new JPH::Factory();
     JPH::RegisterTypes();
     temp_allocator = new JPH::TempAllocatorImpl(10 * 1024 * 1024);  // 10 MB
-    job_system = new JPH::JobSystemThreadPool(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers,
-                                              std::thread::hardware_concurrency() - 1);
+    job_system
+        = new JoltJobSystem(engine_job_system, JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers);
     const JPH::uint cMaxBodies = 65536;
     const JPH::uint cNumBodyMutexes = 0;  // default
     const JPH::uint cMaxBodyPairs = 65536;
@@ -226,6 +225,11 @@ namespace gestalt::application {
     return body;
   }
 
+  void PhysicEngine::remove_body(const JPH::BodyID body_id) {
+    body_interface->RemoveBody(body_id);
+    body_interface->DestroyBody(body_id);
+  }
+
   void PhysicEngine::step_simulation(const float delta_time) const {
     constexpr float fixed_time_step = 1.0f / 60.0f;  // 60 updates per second
     int num_steps = static_cast<int>(std::floor(delta_time / fixed_time_step));
@@ -2,12 +2,12 @@
 #include <glm/fwd.hpp>
 
 namespace gestalt::foundation {
+  class JobSystem;
   struct PhysicsComponent;
 }
 
 namespace JPH {
   class TempAllocatorImpl;
-  class JobSystemThreadPool;
   class PhysicsSystem;
   class BodyInterface;
   class Body;
@@ -20,6 +20,7 @@ namespace gestalt::application {
   class ObjectLayerPairFilterImpl;
   class MyBodyActivationListener;
   class MyContactListener;
+  class JoltJobSystem;
 
   class PhysicEngine {
     BPLayerInterfaceImpl* broad_phase_layer_interface;
@@ -28,14 +29,14 @@ namespace gestalt::application {
     MyBodyActivationListener* body_activation_listener;
     MyContactListener* contact_listener;
     JPH::TempAllocatorImpl* temp_allocator;
-    JPH::JobSystemThreadPool* job_system;
+    JoltJobSystem* job_system;
     JPH::PhysicsSystem* physics_system;
     JPH::BodyInterface* body_interface;
 
     JPH::Body* floor = nullptr;
 
     public:
-    void init();
+    void init(foundation::JobSystem& engine_job_system);
 
     JPH::Body* create_body(foundation::PhysicsComponent& physics_component,
                            const glm::vec3& position, const glm::quat& orientation) const;
@@ -29,8 +29,6 @@ namespace gestalt::application {
   void AssetLoader::load_scene_from_gltf(const std::filesystem::path& file_path) {
     fmt::print("Loading GLTF: {}\n", file_path.string());
 
-    const size_t node_offset = repository_.scene_graph.size();
-
     fastgltf::Asset gltf;
     if (auto asset = parse_gltf(file_path)) {
       gltf = std::move(asset.value());
@@ -41,7 +39,15 @@ namespace gestalt::application {
     size_t image_offset = repository_.textures.size();
     const size_t material_offset = repository_.materials.size();
 
-    import_nodes(gltf);
+    const std::vector<Entity> node_entities = import_nodes(gltf);
+
+    // imported scenes are static until an animation or a dynamic body says otherwise
+    for (const Entity entity : node_entities) {
+      if (const auto node = repository_.scene_graph.find(entity);
+          node != nullptr && node->parent == root_entity) {
+        component_factory_.set_static(entity, true);
+      }
+    }
 
     import_meshes(gltf, material_offset);
 
@@ -49,31 +55,30 @@ namespace gestalt::application {
 
     import_materials(gltf, image_offset);
 
-    import_animations(gltf, node_offset);
+    import_animations(gltf, node_entities);
 
     {  // Import physics
-      for (const auto& [entity, _] : repository_.scene_graph.snapshot()) {
-        if (repository_.mesh_components.find(entity) != nullptr) {
-          const auto& mesh = repository_.meshes.get(repository_.mesh_components.find(entity)->mesh);
-
-          for (const auto& surface : mesh.surfaces) {
-            auto name = repository_.materials.get(surface.material).name;
-            if (name == "DY_SP") {
-              component_factory_.create_physics_component(
-                  entity, DYNAMIC, SphereCollider{mesh.local_bounds.radius});
-            } else if (name == "DY_BO") {
-              const glm::vec3 bounds = mesh.local_aabb.max - mesh.local_aabb.min;
-              component_factory_.create_physics_component(entity, DYNAMIC, BoxCollider{bounds});
-            } else if (name == "ST_BO") {
-              const glm::vec3 bounds = mesh.local_aabb.max - mesh.local_aabb.min;
-              component_factory_.create_physics_component(entity, STATIC, BoxCollider{bounds});
-            } else if (name == "ST_SP") {
-              component_factory_.create_physics_component(
-                  entity, STATIC, SphereCollider{mesh.local_bounds.radius});
-            }
+      repository_.mesh_components.for_each([&](const Entity entity,
+                                               const MeshComponent& mesh_component) {
+        const auto& mesh = repository_.meshes.get(mesh_component.mesh);
+
+        for (const auto& surface : mesh.surfaces) {
+          auto name = repository_.materials.get(surface.material).name;
+          if (name == "DY_SP") {
+            component_factory_.create_physics_component(
+                entity, DYNAMIC, SphereCollider{mesh.local_bounds.radius});
+          } else if (name == "DY_BO") {
+            const glm::vec3 bounds = mesh.local_aabb.max - mesh.local_aabb.min;
+            component_factory_.create_physics_component(entity, DYNAMIC, BoxCollider{bounds});
+          } else if (name == "ST_BO") {
+            const glm::vec3 bounds = mesh.local_aabb.max - mesh.local_aabb.min;
+            component_factory_.create_physics_component(entity, STATIC, BoxCollider{bounds});
+          } else if (name == "ST_SP") {
+            component_factory_.create_physics_component(
+                entity, STATIC, SphereCollider{mesh.local_bounds.radius});
           }
         }
-      }
+      });
     }
   }
 
@@ -90,7 +95,8 @@ namespace gestalt::application {
     return InterpolationType::kLinear;
   }
 
-  void AssetLoader::import_animations(const fastgltf::Asset& gltf, const size_t node_offset) {
+  void AssetLoader::import_animations(const fastgltf::Asset& gltf,
+                                      const std::vector<Entity>& node_entities) {
     if (!gltf.animations.empty()) {
       fmt::print("Importing animations\n");
     }
@@ -105,7 +111,7 @@ namespace gestalt::application {
 
       for (auto& channel : animation.channels) {
         auto& sampler = animation.samplers[channel.samplerIndex];
-        entity = channel.nodeIndex.value_or(0) + node_offset;
+        entity = node_entities[channel.nodeIndex.value_or(0)];
         auto& type = channel.path;
         auto interpolation = MapInterpolationType(sampler.interpolation);
 
@@ -168,15 +174,16 @@ namespace gestalt::application {
     }
   }
 
-  void AssetLoader::import_nodes(fastgltf::Asset& gltf) const {
+  std::vector<Entity> AssetLoader::import_nodes(fastgltf::Asset& gltf) const {
     const size_t mesh_offset = repository_.meshes.size();
-    const size_t node_offset = repository_.scene_graph.size();
 
-    GltfParser::create_nodes(gltf, mesh_offset, &component_factory_);
-    GltfParser::build_hierarchy(gltf.nodes, node_offset, &repository_);
+    std::vector<Entity> node_entities
+        = GltfParser::create_nodes(gltf, mesh_offset, &component_factory_);
+    GltfParser::build_hierarchy(gltf.nodes, node_entities, &component_factory_);
     constexpr Entity root = 0;
-    GltfParser::link_orphans_to_root(root, repository_.scene_graph.find_mutable(root),
-                                     repository_.scene_graph.snapshot(), &repository_);
+    GltfParser::link_orphans_to_root(root, &repository_, &component_factory_);
+
+    return node_entities;
   }
 
   std::optional<fastgltf::Asset> AssetLoader::parse_gltf(const std::filesystem::path& file_path) {
@@ -69,9 +69,9 @@ namespace gestalt::application {
       AssetLoader(AssetLoader&&) = delete;
       AssetLoader& operator=(AssetLoader&&) = delete;
 
-      void import_nodes(fastgltf::Asset& gltf) const;
+      std::vector<Entity> import_nodes(fastgltf::Asset& gltf) const;
       void load_scene_from_gltf(const std::filesystem::path& file_path);
-      void import_animations(const fastgltf::Asset& gltf, const size_t node_offset);
+      void import_animations(const fastgltf::Asset& gltf, const std::vector<Entity>& node_entities);
     };
 
 }  // namespace gestalt::application
\ No newline at end of file
@@ -111,8 +111,11 @@ namespace gestalt::application {
     return surfaces;
   }
 
-  void GltfParser::create_nodes(fastgltf::Asset& gltf, const size_t& mesh_offset,
+  std::vector<Entity> GltfParser::create_nodes(fastgltf::Asset& gltf, const size_t& mesh_offset,
       ComponentFactory* component_factory) {
+    std::vector<Entity> node_entities;
+    node_entities.reserve(gltf.nodes.size());
+
     for (fastgltf::Node& node : gltf.nodes) {
       glm::vec3 position(0.f);
       glm::quat orientation(1.f, 0.f, 0.f, 0.f);
@@ -127,7 +130,8 @@ namespace gestalt::application {
       }
 
       const auto [entity, node_component] = component_factory->create_entity(
-          std::string(node.name), position, orientation, uniform_scale);
+          node.name, position, orientation, uniform_scale);
+      node_entities.push_back(entity);
 
       if (node.lightIndex.has_value()) {
         auto light = gltf.lights.at(node.lightIndex.value());
@@ -191,34 +195,28 @@ namespace gestalt::application {
         component_factory->add_mesh_component(entity, mesh_offset + *node.meshIndex);
       }
     }
+
+    return node_entities;
   }
 
-  void GltfParser::build_hierarchy(std::vector<fastgltf::Node> nodes, const size_t& node_offset,
-      Repository* repository) {
-    for (int i = 0; i < nodes.size(); i++) {
-      fastgltf::Node& node = nodes[i];
-      Entity parent_entity = node_offset + i;
-      auto scene_object = repository->scene_graph.find_mutable(parent_entity);
-
-      for (auto& c : node.children) {
-        Entity child_entity = node_offset + c;
-        auto child = repository->scene_graph.find_mutable(child_entity);
-        scene_object->children.push_back(child_entity);
-        child->parent = parent_entity;
+  void GltfParser::build_hierarchy(const std::vector<fastgltf::Node>& nodes,
+                                   const std::vector<Entity>& node_entities,
+                                   ComponentFactory* component_factory) {
+    for (size_t i = 0; i < nodes.size(); i++) {
+      const Entity parent_entity = node_entities[i];
+      for (const auto& c : nodes[i].children) {
+        component_factory->link_entity_to_parent(node_entities[c], parent_entity);
       }
     }
   }
 
-  void GltfParser::link_orphans_to_root(Entity root, NodeComponent* root_node,
-                                        const std::vector<std::pair<Entity, NodeComponent>>& nodes, Repository* repository) {
-    for (auto& [entity, node] : nodes) {
-      if (entity == root) {
-        continue;
-      }
-
-      if (node.parent == invalid_entity) {
-        root_node->children.push_back(entity);
-        repository->scene_graph.find_mutable(entity)->parent = root;
+  void GltfParser::link_orphans_to_root(Entity root, const Repository* repository,
+                                        ComponentFactory* component_factory) {
+    // nodes without a parent make up the first level of the hierarchy
+    const auto& roots = repository->scene_hierarchy.level(0).entities;
+    for (const Entity entity : std::vector(roots.begin(), roots.end())) {
+      if (entity != root) {
+        component_factory->link_entity_to_parent(entity, root);
       }
     }
   }
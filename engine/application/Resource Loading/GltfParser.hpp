@@ -40,15 +40,16 @@ namespace gestalt::application {
     static std::vector<MeshSurface> extract_mesh(const fastgltf::Asset& gltf, fastgltf::Mesh& mesh,
                                                  size_t material_offset, Repository* repository);
 
-    static void create_nodes(fastgltf::Asset& gltf, const size_t& mesh_offset,
-                             ComponentFactory* component_factory);
+    /** \brief Creates one entity per glTF node and returns them indexed by node. */
+    static std::vector<Entity> create_nodes(fastgltf::Asset& gltf, const size_t& mesh_offset,
+                                            ComponentFactory* component_factory);
 
-    static void build_hierarchy(std::vector<fastgltf::Node> nodes, const size_t& node_offset,
-                                Repository* repository);
+    static void build_hierarchy(const std::vector<fastgltf::Node>& nodes,
+                                const std::vector<Entity>& node_entities,
+                                ComponentFactory* component_factory);
 
-    static void link_orphans_to_root(Entity root, NodeComponent* root_node,
-                                     const std::vector<std::pair<Entity, NodeComponent>>& nodes,
-                                     Repository* repository);
+    static void link_orphans_to_root(Entity root, const Repository* repository,
+                                     ComponentFactory* component_factory);
   };
 
 }  // namespace gestalt::application
\ No newline at end of file
@@ -1,17 +1,22 @@
 ﻿#pragma once
+#include <memory>
+#include <span>
 #include <vector>
 
+#include "CompiledTrack.hpp"
 #include "Keyframe.hpp"
 #include "common.hpp"
 
 namespace gestalt::foundation {
 
   template <typename K> struct AnimationChannel {
-    std::vector<Keyframe<K>> keyframes;
+    std::shared_ptr<const CompiledTrack<K>> track;  // shared by copies, e.g. prefab instances
     float32 current_time = 0.0f;  // Current time in the animation
+    size_t cursor = 0;            // Segment of keyed tracks sampled last
 
-    explicit AnimationChannel(std::vector<Keyframe<K>> keyframes) : keyframes(keyframes) {}
-
+    explicit AnimationChannel(const std::vector<Keyframe<K>>& keyframes)
+        : track(std::make_shared<const CompiledTrack<K>>(
+              compile_track(std::span<const Keyframe<K>>(keyframes)))) {}
   };
 
 }  // namespace gestalt
\ No newline at end of file
@@ -0,0 +1,144 @@
+﻿#include "CompiledTrack.hpp"
+
+#include <cmath>
+
+#include <glm/geometric.hpp>
+
+#include "InterpolationType.hpp"
+
+namespace gestalt::foundation {
+
+  namespace {
+
+    // the same blend the animation system evaluates, a normalized lerp for rotations
+    glm::vec3 blend(const glm::vec3& a, const glm::vec3& b, const float32 weight) {
+      return a + (b - a) * weight;
+    }
+
+    glm::quat blend(const glm::quat& a, const glm::quat& b, const float32 weight) {
+      return glm::normalize(a * (1.f - weight) + b * weight);
+    }
+
+    float32 error(const glm::vec3& a, const glm::vec3& b) { return glm::length(a - b); }
+
+    float32 error(const glm::quat& a, const glm::quat& b) {
+      return 2.f * std::acos(std::min(std::fabs(glm::dot(a, b)), 1.f));
+    }
+
+    glm::vec3 same_hemisphere(const glm::vec3& value, const glm::vec3&) { return value; }
+
+    glm::quat same_hemisphere(const glm::quat& value, const glm::quat& previous) {
+      return glm::dot(value, previous) < 0.f ? -value : value;
+    }
+
+    template <typename V> V evaluate(const CompiledTrack<V>& track, const float32 time) {
+      size_t cursor = 0;
+      const auto sample = track.locate(time, cursor);
+      return blend(track.values[sample.from], track.values[sample.to], sample.weight);
+    }
+
+    /** Drops keys that blending the kept keys around them reproduces within tolerance. */
+    template <typename V> void reduce_keys(CompiledTrack<V>& track, const float32 tolerance) {
+      const size_t count = track.values.size();
+      if (count < 3) {
+        return;
+      }
+
+      const auto fits = [&](const size_t anchor, const size_t end) {
+        const float32 span = track.times[end] - track.times[anchor];
+        for (size_t i = anchor + 1; i < end; ++i) {
+          const float32 weight = span > 0.f ? (track.times[i] - track.times[anchor]) / span : 0.f;
+          if (error(blend(track.values[anchor], track.values[end], weight), track.values[i])
+              > tolerance) {
+            return false;
+          }
+        }
+        return true;
+      };
+
+      // extends the segment from the last kept key as far as it reproduces the keys it skips
+      size_t kept = 1;
+      size_t anchor = 0;
+      for (size_t end = 2; end < count; ++end) {
+        if (!fits(anchor, end)) {
+          anchor = end - 1;
+          track.times[kept] = track.times[anchor];
+          track.values[kept] = track.values[anchor];
+          ++kept;
+        }
+      }
+      track.times[kept] = track.times[count - 1];
+      track.values[kept] = track.values[count - 1];
+      track.times.resize(kept + 1);
+      track.values.resize(kept + 1);
+    }
+
+    template <typename V>
+    CompiledTrack<V> compile(const std::span<const Keyframe<V>> keyframes,
+                             const TrackCompileSettings& settings, const float32 tolerance) {
+      CompiledTrack<V> keyed;
+      if (keyframes.empty()) {
+        return keyed;
+      }
+
+      keyed.start_time = keyframes.front().time;
+      keyed.end_time = keyframes.back().time;
+      const bool has_steps = std::ranges::any_of(keyframes, [](const Keyframe<V>& keyframe) {
+        return keyframe.type == InterpolationType::kStep;
+      });
+      keyed.times.reserve(keyframes.size());
+      keyed.values.reserve(keyframes.size());
+      for (const auto& keyframe : keyframes) {
+        keyed.times.push_back(keyframe.time);
+        keyed.values.push_back(keyed.values.empty()
+                                   ? keyframe.value
+                                   : same_hemisphere(keyframe.value, keyed.values.back()));
+        if (has_steps) {
+          keyed.steps.push_back(keyframe.type == InterpolationType::kStep ? 1 : 0);
+        }
+      }
+
+      const float32 duration = keyed.end_time - keyed.start_time;
+      if (has_steps || keyframes.size() < 2 || duration <= 0.f) {
+        return keyed;
+      }
+
+      // resample before reducing, so the uniform track is as close to the source as it can be
+      CompiledTrack<V> uniform;
+      uniform.start_time = keyed.start_time;
+      uniform.end_time = keyed.end_time;
+      const auto count = static_cast<size_t>(std::ceil(duration * settings.sample_rate)) + 1;
+      uniform.sample_rate = static_cast<float32>(count - 1) / duration;
+      uniform.values.reserve(count);
+      for (size_t i = 0; i < count; ++i) {
+        const float32 time = keyed.start_time + static_cast<float32>(i) / uniform.sample_rate;
+        uniform.values.push_back(evaluate(keyed, std::min(time, keyed.end_time)));
+      }
+
+      bool uniform_fits = true;
+      for (size_t i = 0; i < keyed.values.size() && uniform_fits; ++i) {
+        uniform_fits = error(evaluate(uniform, keyed.times[i]), keyed.values[i]) <= tolerance;
+      }
+
+      reduce_keys(keyed, tolerance);
+      if (uniform_fits && uniform.bytes() < keyed.bytes()) {
+        return uniform;
+      }
+      keyed.times.shrink_to_fit();
+      keyed.values.shrink_to_fit();
+      return keyed;
+    }
+
+  }  // namespace
+
+  CompiledTrack<glm::vec3> compile_track(const std::span<const Keyframe<glm::vec3>> keyframes,
+                                         const TrackCompileSettings& settings) {
+    return compile(keyframes, settings, settings.position_tolerance);
+  }
+
+  CompiledTrack<glm::quat> compile_track(const std::span<const Keyframe<glm::quat>> keyframes,
+                                         const TrackCompileSettings& settings) {
+    return compile(keyframes, settings, settings.rotation_tolerance);
+  }
+
+}  // namespace gestalt::foundation
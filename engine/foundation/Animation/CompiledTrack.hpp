@@ -0,0 +1,113 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <span>
+#include <vector>
+
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "Keyframe.hpp"
+#include "common.hpp"
+
+namespace gestalt::foundation {
+
+  struct TrackCompileSettings {
+    float32 sample_rate = 30.f;           // samples per second of uniform tracks
+    float32 position_tolerance = 1e-4f;   // largest distance to the source keys
+    float32 rotation_tolerance = 1e-4f;   // largest angle to the source keys in radians
+  };
+
+  /**
+   * \brief One animated property in the form it is evaluated in, produced by compile_track.
+   *
+   * A uniform track holds samples at a fixed rate, so finding the samples around a time is index
+   * arithmetic. A keyed track holds the remaining keys after reduction as separate time and value
+   * arrays and is searched from a cursor. Keys are interpolated as their keyframe says, a step key
+   * holds its value until the next key, so a track may mix stepped and blended segments.
+   * Consecutive rotations always lie in the same hemisphere, so blending two neighbours never needs
+   * a sign test.
+   */
+  template <typename V> struct CompiledTrack {
+    float32 start_time = 0.f;
+    float32 end_time = 0.f;
+    float32 sample_rate = 0.f;  // 0 for keyed tracks
+    std::vector<float32> times; // keyed tracks only
+    std::vector<uint8> steps;   // per key of keyed tracks, 1 holds it; empty without step keys
+    std::vector<V> values;
+
+    /** \brief The two values to blend and the weight of the second. */
+    struct Sample {
+      uint32 from = 0;
+      uint32 to = 0;
+      float32 weight = 0.f;
+    };
+
+    [[nodiscard]] bool empty() const { return values.empty(); }
+    [[nodiscard]] bool uniform() const { return sample_rate > 0.f; }
+    [[nodiscard]] size_t bytes() const {
+      return times.size() * sizeof(float32) + steps.size() * sizeof(uint8)
+             + values.size() * sizeof(V);
+    }
+
+    /**
+     * \brief Locates time, clamped to the track. cursor caches the segment of keyed tracks:
+     * playback moves forward by a few keys per frame, seeks and loops fall back to a binary search.
+     */
+    [[nodiscard]] Sample locate(const float32 time, size_t& cursor) const {
+      assert(!empty());
+      const auto last = static_cast<uint32>(values.size() - 1);
+      if (last == 0) {
+        return {};
+      }
+
+      if (uniform()) {
+        const float32 position
+            = std::clamp((time - start_time) * sample_rate, 0.f, static_cast<float32>(last));
+        const auto from = std::min(static_cast<uint32>(position), last - 1);
+        return {from, from + 1, position - static_cast<float32>(from)};
+      }
+
+      const auto from = static_cast<uint32>(segment(time, cursor));
+      const float32 span = times[from + 1] - times[from];
+      const bool step = !steps.empty() && steps[from] != 0;
+      const float32 weight = step || span <= 0.f
+                                 ? (time >= times[from + 1] ? 1.f : 0.f)
+                                 : std::clamp((time - times[from]) / span, 0.f, 1.f);
+      return {from, from + 1, weight};
+    }
+
+  private:
+    [[nodiscard]] size_t segment(const float32 time, size_t& cursor) const {
+      constexpr size_t kMaxSteps = 4;
+      const size_t last = times.size() - 2;
+
+      size_t index = std::min(cursor, last);
+      for (size_t step = 0; step < kMaxSteps && index < last && time >= times[index + 1];
+           ++step) {
+        ++index;
+      }
+
+      if ((index > 0 && time < times[index]) || (index < last && time >= times[index + 1])) {
+        const auto next = std::upper_bound(times.begin(), times.end(), time);
+        index = std::clamp<size_t>(static_cast<size_t>(next - times.begin()), 1, last + 1) - 1;
+      }
+
+      cursor = index;
+      return index;
+    }
+  };
+
+  /**
+   * \brief Compiles keyframes into the smaller of a uniformly resampled and a keyed track. Keys
+   * that linear blending of their neighbours reproduces within the tolerance are dropped, a
+   * uniform track is only used if it reproduces every source key within the tolerance. Tracks with
+   * any step interpolated keyframe stay keyed and complete.
+   */
+  CompiledTrack<glm::vec3> compile_track(std::span<const Keyframe<glm::vec3>> keyframes,
+                                         const TrackCompileSettings& settings = {});
+  CompiledTrack<glm::quat> compile_track(std::span<const Keyframe<glm::quat>> keyframes,
+                                         const TrackCompileSettings& settings = {});
+
+}  // namespace gestalt::foundation
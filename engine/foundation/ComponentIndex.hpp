@@ -0,0 +1,119 @@
+﻿#pragma once
+
+#include <array>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "common.hpp"
+
+namespace gestalt::foundation {
+
+  /**
+   * \brief Index policies of ComponentStorage. Both map the index part of an entity handle to a
+   * dense slot and differ only in what that costs: PagedIndex is two array lookups but allocates
+   * 16 KiB pages that cover the whole entity range in use, HashIndex stays proportional to the
+   * number of components and suits types that only few entities own, e.g. cameras.
+   */
+  class PagedIndex {
+    static constexpr uint32 kPageBits = 12;
+    static constexpr uint32 kPageSize = 1u << kPageBits;
+    static constexpr uint32 kPageMask = kPageSize - 1;
+
+    using Page = std::array<uint32, kPageSize>;
+
+  public:
+    static constexpr uint32 kInvalid = std::numeric_limits<uint32>::max();
+
+    [[nodiscard]] uint32 find(const uint32 key) const {
+      const uint32 page = key >> kPageBits;
+      if (page >= pages_.size() || pages_[page] == nullptr) {
+        return kInvalid;
+      }
+      return (*pages_[page])[key & kPageMask];
+    }
+
+    /** \brief Returns the slot for key, which is kInvalid if it was not assigned yet. */
+    [[nodiscard]] uint32& slot(const uint32 key) {
+      const uint32 page = key >> kPageBits;
+      if (page >= pages_.size()) {
+        pages_.resize(page + 1);
+      }
+      if (pages_[page] == nullptr) {
+        pages_[page] = std::make_unique<Page>();
+        pages_[page]->fill(kInvalid);
+      }
+      return (*pages_[page])[key & kPageMask];
+    }
+
+    void erase(const uint32 key) { slot(key) = kInvalid; }
+
+    /** \brief Address the lookup of key will read, nullptr if there is none. */
+    [[nodiscard]] const void* address(const uint32 key) const {
+      const uint32 page = key >> kPageBits;
+      return page < pages_.size() && pages_[page] != nullptr ? &(*pages_[page])[key & kPageMask]
+                                                           : nullptr;
+    }
+
+    [[nodiscard]] size_t bytes() const {
+      size_t bytes = pages_.capacity() * sizeof(std::unique_ptr<Page>);
+      for (const auto& page : pages_) {
+        bytes += page != nullptr ? sizeof(Page) : 0;
+      }
+      return bytes;
+    }
+
+  private:
+    std::vector<std::unique_ptr<Page>> pages_;
+  };
+
+  class HashIndex {
+  public:
+    static constexpr uint32 kInvalid = std::numeric_limits<uint32>::max();
+
+    [[nodiscard]] uint32 find(const uint32 key) const {
+      const auto it = slots_.find(key);
+      return it != slots_.end() ? it->second : kInvalid;
+    }
+
+    [[nodiscard]] uint32& slot(const uint32 key) {
+      return slots_.try_emplace(key, kInvalid).first->second;
+    }
+
+    void erase(const uint32 key) { slots_.erase(key); }
+
+    [[nodiscard]] const void* address(uint32) const { return nullptr; }
+
+    [[nodiscard]] size_t bytes() const {
+      // buckets plus one node per entry, close enough for statistics
+      return slots_.bucket_count() * sizeof(void*)
+             + slots_.size() * (sizeof(std::pair<const uint32, uint32>) + 2 * sizeof(void*));
+    }
+
+  private:
+    std::unordered_map<uint32, uint32> slots_;
+  };
+
+  /**
+   * \brief Picks the index of a component type's storage. Types choose HashIndex with a member
+   * alias `using storage_index = HashIndex;`, all others use PagedIndex.
+   */
+  template <typename ComponentType> struct ComponentIndexOf {
+    using type = PagedIndex;
+  };
+
+  template <typename ComponentType>
+    requires requires { typename ComponentType::storage_index; }
+  struct ComponentIndexOf<ComponentType> {
+    using type = typename ComponentType::storage_index;
+  };
+
+  /** \brief Generic statistics every component storage reports. */
+  struct StorageStats {
+    size_t count = 0;
+    size_t bytes = 0;
+    uint64 churn = 0;  // insertions, changes and removals since the last change window opened
+  };
+
+}  // namespace gestalt::foundation
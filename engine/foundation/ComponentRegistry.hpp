@@ -0,0 +1,65 @@
+﻿#pragma once
+
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "common.hpp"
+#include "ComponentIndex.hpp"
+#include "ComponentStorage.hpp"
+#include "TagStorage.hpp"
+#include "TypeName.hpp"
+#include "Components/Entity.hpp"
+
+namespace gestalt::foundation {
+
+  /** \brief Storage a registry keeps for a component type; empty types are stored as tags. */
+  template <typename ComponentType> using StorageOf
+      = std::conditional_t<std::is_empty_v<ComponentType>, TagStorage<ComponentType>,
+                           ComponentStorage<ComponentType>>;
+
+  /**
+   * \brief Owns one storage per component type. A type's id is its position in Components, so ids
+   * are compile-time constants and storage<T>() resolves to a tuple element without any lookup.
+   * The storage policy follows the type: empty types get a TagStorage, everything else a
+   * ComponentStorage with the index the type asks for (see ComponentIndexOf).
+   */
+  template <typename... Components> class ComponentRegistry {
+  public:
+    static constexpr size_t kCount = sizeof...(Components);
+
+    template <typename T> [[nodiscard]] static constexpr uint32 id() {
+      static_assert((std::is_same_v<T, Components> || ...), "component type is not registered");
+      uint32 index = 0;
+      bool found = false;
+      ((found = found || std::is_same_v<T, Components>, index += found ? 0 : 1), ...);
+      return index;
+    }
+
+    template <typename T> [[nodiscard]] StorageOf<T>& storage() {
+      return std::get<id<T>()>(storages_);
+    }
+
+    template <typename T> [[nodiscard]] const StorageOf<T>& storage() const {
+      return std::get<id<T>()>(storages_);
+    }
+
+    /** \brief Removes the entity from every storage. */
+    void remove(const Entity entity) {
+      std::apply([entity](auto&... storages) { (storages.remove(entity), ...); }, storages_);
+    }
+
+    void advance_change_windows() {
+      std::apply([](auto&... storages) { (storages.advance_change_window(), ...); }, storages_);
+    }
+
+    /** \brief Calls fn(uint32 id, std::string_view name, const StorageStats&) for every storage. */
+    template <typename Fn> void for_each_storage(Fn&& fn) const {
+      (fn(id<Components>(), type_name<Components>(), storage<Components>().stats()), ...);
+    }
+
+  private:
+    std::tuple<StorageOf<Components>...> storages_;
+  };
+
+}  // namespace gestalt::foundation
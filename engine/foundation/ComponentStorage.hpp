@@ -0,0 +1,247 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <span>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#  include <xmmintrin.h>
+#endif
+
+#include "common.hpp"
+#include "ComponentIndex.hpp"
+#include "Components/Entity.hpp"
+
+namespace gestalt::foundation {
+
+  inline void prefetch_read(const void* address) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#else
+    (void)address;
+#endif
+  }
+
+  /**
+   * \brief Sparse-set storage for one component type.
+   *
+   * Components are packed in a dense array with a parallel array of their owning entities, so
+   * iteration is a linear walk over contiguous memory. The Index policy maps an entity to its
+   * dense slot, a two-level array access by default (see ComponentIndex.hpp). The index is keyed
+   * by the slot part of the handle and a lookup only succeeds if the stored handle matches, so
+   * handles of destroyed entities never resolve to a recycled slot. An upsert through a later
+   * generation takes over a row an earlier one left behind, one through an earlier generation is
+   * refused. The storage cannot tell a dead handle of an unused slot from a live one, callers
+   * write through live handles only. Removing swaps the
+   * last element into the hole, so pointers and dense indices are only stable until the next
+   * insertion or removal.
+   *
+   * Changes are tracked with a storage version that is bumped on every upsert and mark_changed.
+   * Each change is appended to a log together with its version, so systems can visit exactly the
+   * entities changed since the version they last saw. The log keeps at least one full change
+   * window (see advance_change_window) and must be consumed at least once per window.
+   */
+  template <typename ComponentType,
+            typename Index = typename ComponentIndexOf<ComponentType>::type>
+  class ComponentStorage {
+    static constexpr uint32 kInvalidIndex = Index::kInvalid;
+
+  public:
+    [[nodiscard]] const ComponentType* find(Entity ent) const {
+      const uint32 index = dense_index(ent);
+      return index != kInvalidIndex ? &components_[index] : nullptr;
+    }
+
+    [[nodiscard]] ComponentType* find_mutable(Entity ent) {
+      const uint32 index = dense_index(ent);
+      return index != kInvalidIndex ? &components_[index] : nullptr;
+    }
+
+    [[nodiscard]] bool contains(Entity ent) const { return dense_index(ent) != kInvalidIndex; }
+
+    /** \brief Hints the cache to load the sparse slot of ent ahead of a lookup. */
+    void prefetch(Entity ent) const {
+      if (const void* address = index_.address(entity_index(ent)); address != nullptr) {
+        prefetch_read(address);
+      }
+    }
+
+    void upsert(Entity ent, const ComponentType& component) {
+      assert(ent != invalid_entity && "cannot store a component for an invalid entity");
+
+      uint32& slot = sparse_slot(ent);
+      if (slot != kInvalidIndex) {
+        if (entities_[slot] != ent) {
+          // a stale handle must not overwrite the component of the entity that owns the slot now,
+          // while a row left behind by an earlier generation is taken over
+          if (!is_newer_generation(ent, entities_[slot])) {
+            assert(false && "the slot is owned by a later generation of this entity");
+            return;
+          }
+          entities_[slot] = ent;
+        }
+        components_[slot] = component;
+        log_change(slot);
+        return;
+      }
+
+      slot = static_cast<uint32>(entities_.size());
+      entities_.push_back(ent);
+      components_.push_back(component);
+      versions_.push_back(0);
+      log_change(slot);
+    }
+
+    /** \brief Records a change to a component that was modified through find_mutable. */
+    void mark_changed(Entity ent) {
+      if (const uint32 index = dense_index(ent); index != kInvalidIndex) {
+        log_change(index);
+      }
+    }
+
+    /** \brief Version of the most recent change; pass it to for_each_changed_since later on. */
+    [[nodiscard]] uint64 version() const { return version_; }
+
+    /**
+     * \brief Calls fn(Entity, ComponentType&) once for every live entity whose component changed
+     * after the given version. Same iteration rules as for_each.
+     */
+    template <typename Fn> void for_each_changed_since(const uint64 since, Fn&& fn) {
+      assert(since >= trimmed_version_ && "change log was trimmed past the requested version");
+      for (auto it = first_change_after(since); it != changes_.end(); ++it) {
+        if (const uint32 index = dense_index(it->entity);
+            index != kInvalidIndex && versions_[index] == it->version) {
+          fn(it->entity, components_[index]);
+        }
+      }
+    }
+
+    template <typename Fn> void for_each_changed_since(const uint64 since, Fn&& fn) const {
+      assert(since >= trimmed_version_ && "change log was trimmed past the requested version");
+      for (auto it = first_change_after(since); it != changes_.end(); ++it) {
+        if (const uint32 index = dense_index(it->entity);
+            index != kInvalidIndex && versions_[index] == it->version) {
+          fn(it->entity, static_cast<const ComponentType&>(components_[index]));
+        }
+      }
+    }
+
+    [[nodiscard]] bool changed_since(const uint64 since) const { return version_ > since; }
+
+    /**
+     * \brief Drops log entries older than the previous window and opens a new one. Called once per
+     * frame, so consumers that run every frame never miss a change.
+     */
+    void advance_change_window() {
+      const auto first_kept = first_change_after(window_start_);
+      changes_.erase(changes_.begin(), first_kept);
+      trimmed_version_ = window_start_;
+      window_start_ = version_;
+    }
+
+    void remove(Entity ent) {
+      const uint32 index = dense_index(ent);
+      if (index == kInvalidIndex) {
+        return;
+      }
+
+      const uint32 last = static_cast<uint32>(entities_.size() - 1);
+      if (index != last) {
+        const Entity moved = entities_[last];
+        entities_[index] = moved;
+        components_[index] = std::move(components_[last]);
+        versions_[index] = versions_[last];
+        sparse_slot(moved) = index;
+      }
+
+      index_.erase(entity_index(ent));
+      entities_.pop_back();
+      components_.pop_back();
+      versions_.pop_back();
+      ++version_;
+    }
+
+    /**
+     * \brief Calls fn(Entity, ComponentType&) for every component in dense order.
+     * Components may be modified, but the storage must not be inserted into or removed from
+     * while iterating.
+     */
+    template <typename Fn> void for_each(Fn&& fn) {
+      for (size_t i = 0; i < components_.size(); ++i) {
+        fn(entities_[i], components_[i]);
+      }
+    }
+
+    /** \brief Calls fn(Entity, const ComponentType&) for every component in dense order. */
+    template <typename Fn> void for_each(Fn&& fn) const {
+      for (size_t i = 0; i < components_.size(); ++i) {
+        fn(entities_[i], components_[i]);
+      }
+    }
+
+    /** \brief Owning entities, index-aligned with components(). */
+    [[nodiscard]] std::span<const Entity> entities() const { return entities_; }
+
+    [[nodiscard]] std::span<ComponentType> components() { return components_; }
+    [[nodiscard]] std::span<const ComponentType> components() const { return components_; }
+
+    void reserve(size_t capacity) {
+      entities_.reserve(capacity);
+      components_.reserve(capacity);
+      versions_.reserve(capacity);
+    }
+
+    [[nodiscard]] size_t size() const { return components_.size(); }
+    [[nodiscard]] bool empty() const { return components_.empty(); }
+
+    [[nodiscard]] StorageStats stats() const {
+      return {
+          .count = components_.size(),
+          .bytes = index_.bytes() + entities_.capacity() * sizeof(Entity)
+                   + components_.capacity() * sizeof(ComponentType)
+                   + versions_.capacity() * sizeof(uint64) + changes_.capacity() * sizeof(Change),
+          .churn = version_ - window_start_,
+      };
+    }
+
+  private:
+    struct Change {
+      Entity entity;
+      uint64 version;
+    };
+
+    void log_change(const uint32 index) {
+      versions_[index] = ++version_;
+      changes_.push_back({entities_[index], version_});
+    }
+
+    [[nodiscard]] auto first_change_after(const uint64 since) const {
+      return std::upper_bound(changes_.begin(), changes_.end(), since,
+                              [](const uint64 version, const Change& change) {
+                                return version < change.version;
+                              });
+    }
+
+    [[nodiscard]] uint32 dense_index(Entity ent) const {
+      const uint32 slot = index_.find(entity_index(ent));
+      return slot != kInvalidIndex && entities_[slot] == ent ? slot : kInvalidIndex;
+    }
+
+    uint32& sparse_slot(Entity ent) { return index_.slot(entity_index(ent)); }
+
+    Index index_;
+    std::vector<Entity> entities_;
+    std::vector<ComponentType> components_;
+    std::vector<uint64> versions_;
+
+    std::vector<Change> changes_;
+    uint64 version_ = 0;
+    uint64 window_start_ = 0;
+    uint64 trimmed_version_ = 0;
+  };
+
+}  // namespace gestalt::foundation
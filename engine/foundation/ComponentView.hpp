@@ -0,0 +1,95 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "ComponentStorage.hpp"
+
+namespace gestalt::foundation {
+
+  template <typename Component> using StorageFor
+      = std::conditional_t<std::is_const_v<Component>,
+                           const ComponentStorage<std::remove_const_t<Component>>,
+                           ComponentStorage<Component>>;
+
+  /**
+   * \brief Join over several component storages.
+   *
+   * for_each walks the dense array of the smallest participating storage and resolves the other
+   * components through their sparse indices, prefetching a few entities ahead. Only entities that
+   * own every component are visited. Declare a component as const to get read-only access, e.g.
+   * view<const TransformComponent, MeshComponent>(). Iteration order follows the driving storage.
+   */
+  template <typename... Components> class ComponentView {
+    static_assert(sizeof...(Components) > 0, "a view needs at least one component type");
+    static constexpr size_t kPrefetchDistance = 8;
+
+  public:
+    explicit ComponentView(StorageFor<Components>&... storages) : storages_(&storages...) {}
+
+    /** \brief Calls fn(Entity, Components&...) for every entity that owns all components. */
+    template <typename Fn> void for_each(Fn&& fn) const {
+      const size_t driver = smallest_storage(std::index_sequence_for<Components...>{});
+      dispatch(driver, fn, std::index_sequence_for<Components...>{});
+    }
+
+    /** \brief Upper bound on the number of entities visited by for_each. */
+    [[nodiscard]] size_t size_hint() const {
+      return std::apply([](const auto*... storages) { return std::min({storages->size()...}); },
+                        storages_);
+    }
+
+  private:
+    template <size_t... I> [[nodiscard]] size_t smallest_storage(std::index_sequence<I...>) const {
+      size_t smallest = 0;
+      size_t smallest_size = std::get<0>(storages_)->size();
+      ((std::get<I>(storages_)->size() < smallest_size
+            ? (smallest = I, smallest_size = std::get<I>(storages_)->size())
+            : 0),
+       ...);
+      return smallest;
+    }
+
+    template <typename Fn, size_t... I>
+    void dispatch(const size_t driver, Fn& fn, std::index_sequence<I...>) const {
+      ((driver == I ? iterate<I>(fn, std::index_sequence<I...>{}) : void()), ...);
+    }
+
+    template <size_t Driver, typename Fn, size_t... I>
+    void iterate(Fn& fn, std::index_sequence<I...>) const {
+      auto* driver = std::get<Driver>(storages_);
+      const auto entities = driver->entities();
+      auto components = driver->components();
+
+      for (size_t i = 0; i < entities.size(); ++i) {
+        if (i + kPrefetchDistance < entities.size()) {
+          const Entity ahead = entities[i + kPrefetchDistance];
+          ((I != Driver ? std::get<I>(storages_)->prefetch(ahead) : void()), ...);
+        }
+
+        const Entity entity = entities[i];
+        auto resolved = std::make_tuple(resolve<I, Driver>(entity, components[i])...);
+        if (((std::get<I>(resolved) != nullptr) && ...)) {
+          fn(entity, *std::get<I>(resolved)...);
+        }
+      }
+    }
+
+    template <size_t I, size_t Driver, typename DriverComponent>
+    auto resolve(const Entity entity, DriverComponent& driver_component) const {
+      using Component = std::tuple_element_t<I, std::tuple<Components...>>;
+      if constexpr (I == Driver) {
+        return static_cast<Component*>(&driver_component);
+      } else if constexpr (std::is_const_v<Component>) {
+        return std::get<I>(storages_)->find(entity);
+      } else {
+        return std::get<I>(storages_)->find_mutable(entity);
+      }
+    }
+
+    std::tuple<StorageFor<Components>*...> storages_;
+  };
+
+}  // namespace gestalt::foundation
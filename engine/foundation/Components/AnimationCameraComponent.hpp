@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "Component.hpp"
+#include "ComponentIndex.hpp"
 #include "glm/vec3.hpp"
 #include "glm/gtc/quaternion.hpp"
 #include "glm/gtx/transform.hpp"
@@ -8,6 +9,8 @@
 namespace gestalt::foundation {
 
   struct AnimationCameraComponent : Component {
+    using storage_index = HashIndex;
+
   private:
       glm::vec3 position_ = glm::vec3(0.0f);
       glm::quat orientation_ = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
@@ -2,8 +2,10 @@
 
 namespace gestalt::foundation {
 
-  struct Component {
-    mutable bool is_dirty = true;
-  };
+  /**
+   * \brief Common base of all components. Change tracking lives in ComponentStorage, so
+   * components that are modified in place must be reported with ComponentStorage::mark_changed.
+   */
+  struct Component {};
 
 }  // namespace gestalt::foundation
\ No newline at end of file
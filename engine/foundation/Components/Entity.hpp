@@ -5,7 +5,33 @@
 
 namespace gestalt::foundation {
 
+    /**
+     * \brief Generational entity handle.
+     * The low kEntityIndexBits bits address a slot, the remaining bits count how often that slot
+     * has been recycled so stale handles can be told apart from live ones.
+     */
     using Entity = uint32;
+
+    constexpr uint32 kEntityIndexBits = 24;
+    constexpr uint32 kEntityIndexMask = (1u << kEntityIndexBits) - 1;
+    constexpr uint32 kEntityGenerationMask = (1u << (32 - kEntityIndexBits)) - 1;
+
+    constexpr uint32 entity_index(const Entity entity) { return entity & kEntityIndexMask; }
+    constexpr uint32 entity_generation(const Entity entity) { return entity >> kEntityIndexBits; }
+    constexpr Entity make_entity(const uint32 index, const uint32 generation) {
+      return (generation & kEntityGenerationMask) << kEntityIndexBits | (index & kEntityIndexMask);
+    }
+
+    /**
+     * \brief Whether entity holds a later generation of its slot than other. Generations wrap
+     * around, so the later one is the one at most half the generation range ahead.
+     */
+    constexpr bool is_newer_generation(const Entity entity, const Entity other) {
+      const uint32 distance
+          = (entity_generation(entity) - entity_generation(other)) & kEntityGenerationMask;
+      return distance != 0 && distance <= kEntityGenerationMask / 2;
+    }
+
     constexpr Entity root_entity = 0;
     constexpr uint32 invalid_entity = std::numeric_limits<uint32>::max();
     constexpr size_t no_component = std::numeric_limits<size_t>::max();
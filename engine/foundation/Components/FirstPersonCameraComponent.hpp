@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "Component.hpp"
+#include "ComponentIndex.hpp"
 #include "UserInput.hpp"
 #include "glm/vec3.hpp"
 #include "glm/gtc/quaternion.hpp"
@@ -8,6 +9,8 @@
 namespace gestalt::foundation {
 
   struct FirstPersonCameraComponent : Component {
+    using storage_index = HashIndex;
+
   private:
       glm::vec3 position_;
       glm::quat orientation_ = glm::quat(glm::vec3(0.0f));
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "Component.hpp"
+#include "ComponentIndex.hpp"
 #include "UserInput.hpp"
 #include "glm/vec3.hpp"
 #include "glm/ext/matrix_transform.hpp"
@@ -9,6 +10,8 @@
 namespace gestalt::foundation {
 
   struct FreeFlyCameraComponent : Component {
+    using storage_index = HashIndex;
+
   private:
     glm::vec3 position_ = glm::vec3(0.0f, 0.0f, 5.0f);
     glm::vec3 up_ = glm::vec3(0.0f, 1.0f, 0.0f);
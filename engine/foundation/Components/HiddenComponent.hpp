@@ -0,0 +1,10 @@
+﻿#pragma once
+
+#include "Component.hpp"
+
+namespace gestalt::foundation {
+
+  /** \brief Tag that hides the entity and its subtree from rendering. */
+  struct HiddenComponent : Component {};
+
+}  // namespace gestalt::foundation
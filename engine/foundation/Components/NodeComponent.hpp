@@ -1,19 +1,25 @@
 ﻿#pragma once
-#include <string>
-#include <vector>
 
 #include "Component.hpp"
 #include "Entity.hpp"
+#include "StringTable.hpp"
 #include "Mesh/AABB.hpp"
 
 namespace gestalt::foundation {
 
+    /**
+     * \brief Children form an intrusive doubly linked list starting at first_child, so the
+     * component owns no heap memory and linking or unlinking a node is O(1). The name is an id
+     * into Repository::names.
+     */
     struct NodeComponent :Component {
-      std::string name;
+      StringId name = StringTable::kEmpty;
       Entity parent = invalid_entity;
-      std::vector<Entity> children;
+      Entity first_child = invalid_entity;
+      Entity next_sibling = invalid_entity;
+      Entity previous_sibling = invalid_entity;
       AABB bounds;
-      bool visible = true;
+      bool contributes_to_bounds = true;  // false for nodes without geometry, e.g. cameras and lights
     };
 
 }  // namespace gestalt
\ No newline at end of file
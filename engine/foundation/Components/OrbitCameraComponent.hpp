@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "Component.hpp"
+#include "ComponentIndex.hpp"
 #include "glm/vec3.hpp"
 #include <glm/common.hpp>
 
@@ -10,6 +11,8 @@
 namespace gestalt::foundation {
 
   struct OrbitCameraComponent : Component {
+    using storage_index = HashIndex;
+
   private:
 
     glm::vec3 target_;
@@ -2,6 +2,7 @@
 #include <variant>
 
 #include "Component.hpp"
+#include "ComponentIndex.hpp"
 #include "common.hpp"
 #include "glm/mat4x4.hpp"
 #include "glm/ext/matrix_clip_space.hpp"
@@ -9,6 +10,8 @@
 namespace gestalt::foundation {
 
   struct OrthographicProjectionComponent : Component {
+    using storage_index = HashIndex;
+
   private:
     float32 left_;
     float32 right_;
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "Component.hpp"
+#include "ComponentIndex.hpp"
 #include "common.hpp"
 #include "glm/mat4x4.hpp"
 #include "glm/ext/matrix_clip_space.hpp"
@@ -8,6 +9,8 @@
 namespace gestalt::foundation {
 
   struct PerspectiveProjectionComponent : Component {
+    using storage_index = HashIndex;
+
   private:
     float32 fov_;  // in radians
     float32 near_;
@@ -0,0 +1,13 @@
+﻿#pragma once
+
+#include "Component.hpp"
+
+namespace gestalt::foundation {
+
+  /**
+   * \brief Tag for entities that keep their world transform once placed. Only whole subtrees are
+   * static, an entity below a movable parent is movable itself (see ComponentFactory::set_static).
+   */
+  struct StaticComponent : Component {};
+
+}  // namespace gestalt::foundation
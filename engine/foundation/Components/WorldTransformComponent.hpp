@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include "glm/vec3.hpp"
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/ext/matrix_transform.hpp"
+
+#include "Component.hpp"
+#include "TransformComponent.hpp"
+#include "common.hpp"
+
+namespace gestalt::foundation {
+
+  /**
+   * \brief World-space transform of a scene node, derived from the local TransformComponents of
+   * the node and its ancestors. Written by the TransformSystem once per frame for dirty subtrees
+   * and read by everything that needs world positions.
+   */
+  struct WorldTransformComponent : Component {
+    glm::vec3 position{0.f};
+    glm::quat rotation{1.f, 0.f, 0.f, 0.f};
+    float32 scale = 1.f;  // uniform, like TransformComponent
+    glm::mat4 matrix{1.f};
+
+    WorldTransformComponent() = default;
+
+    WorldTransformComponent(const glm::vec3& world_position, const glm::quat& world_rotation,
+                            const float32 world_scale)
+        : position(world_position), rotation(world_rotation), scale(world_scale) {
+      update_matrix();
+    }
+
+    explicit WorldTransformComponent(const TransformComponent& local)
+        : position(local.position()), rotation(local.rotation()), scale(local.scale_uniform()) {
+      update_matrix();
+    }
+
+    /** \brief Transform of a child with the given local transform. */
+    [[nodiscard]] WorldTransformComponent operator*(const TransformComponent& local) const {
+      WorldTransformComponent result;
+      result.position = position + rotation * (scale * local.position());
+      result.rotation = rotation * local.rotation();
+      result.scale = scale * local.scale_uniform();
+      result.update_matrix();
+      return result;
+    }
+
+    void update_matrix() {
+      matrix = glm::translate(glm::mat4(1.f), position) * glm::mat4_cast(rotation)
+               * glm::scale(glm::mat4(1.f), glm::vec3(scale));
+    }
+  };
+
+}  // namespace gestalt::foundation
@@ -0,0 +1,350 @@
+﻿#include "DynamicBvh.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstdlib>
+
+namespace gestalt::foundation {
+
+  uint32 DynamicBvh::leaf(const Entity entity) const {
+    const uint32 index = entity_index(entity);
+    if (index >= leaves_.size() || leaves_[index] == kNull) {
+      return kNull;
+    }
+    const uint32 node = leaves_[index];
+    return nodes_[node].entity == entity ? node : kNull;
+  }
+
+  bool DynamicBvh::update(const Entity entity, const AABB& bounds) {
+    assert(entity != invalid_entity);
+    const Box tight{bounds.min, bounds.max};
+    const Box fat{tight.min - glm::vec3(kMargin), tight.max + glm::vec3(kMargin)};
+
+    uint32 node = leaf(entity);
+    const bool inserted = node == kNull;
+    if (inserted) {
+      const uint32 index = entity_index(entity);
+      if (index >= leaves_.size()) {
+        leaves_.resize(index + 1, kNull);
+      }
+      node = allocate_node();
+      nodes_[node].entity = entity;
+      leaves_[index] = node;
+      ++leaf_count_;
+    } else if (nodes_[node].box.contains(tight)) {
+      return false;
+    } else {
+      remove_leaf(node);
+    }
+
+    nodes_[node].box = fat;
+    insert_leaf(node);
+    return inserted;
+  }
+
+  void DynamicBvh::remove(const Entity entity) {
+    const uint32 node = leaf(entity);
+    if (node == kNull) {
+      return;
+    }
+    remove_leaf(node);
+    free_node(node);
+    leaves_[entity_index(entity)] = kNull;
+    --leaf_count_;
+  }
+
+  void DynamicBvh::clear() {
+    nodes_.clear();
+    leaves_.clear();
+    root_ = kNull;
+    free_list_ = kNull;
+    leaf_count_ = 0;
+  }
+
+  uint32 DynamicBvh::allocate_node() {
+    if (free_list_ == kNull) {
+      nodes_.emplace_back();
+      return static_cast<uint32>(nodes_.size() - 1);
+    }
+    const uint32 node = free_list_;
+    free_list_ = nodes_[node].parent;
+    nodes_[node] = Node{};
+    return node;
+  }
+
+  void DynamicBvh::free_node(const uint32 node) {
+    nodes_[node] = Node{};
+    nodes_[node].parent = free_list_;
+    nodes_[node].height = -1;
+    free_list_ = node;
+  }
+
+  void DynamicBvh::insert_leaf(const uint32 leaf) {
+    if (root_ == kNull) {
+      root_ = leaf;
+      nodes_[leaf].parent = kNull;
+      return;
+    }
+
+    // walk down to the sibling that makes the tree grow the least
+    const Box box = nodes_[leaf].box;
+    uint32 index = root_;
+    while (!nodes_[index].is_leaf()) {
+      const Node& node = nodes_[index];
+      const float32 area = node.box.area();
+      const float32 combined_area = Box::merge(node.box, box).area();
+
+      // pairing with this node creates a parent with the combined box, descending further
+      // grows this node's box by the difference on top of the cost of the child
+      const float32 cost = 2.f * combined_area;
+      const float32 inheritance_cost = 2.f * (combined_area - area);
+
+      const auto child_cost = [&](const uint32 child) {
+        const Box& child_box = nodes_[child].box;
+        const float32 merged = Box::merge(child_box, box).area();
+        return (nodes_[child].is_leaf() ? merged : merged - child_box.area()) + inheritance_cost;
+      };
+      const float32 left_cost = child_cost(node.left);
+      const float32 right_cost = child_cost(node.right);
+
+      if (cost < left_cost && cost < right_cost) {
+        break;
+      }
+      index = left_cost < right_cost ? node.left : node.right;
+    }
+
+    const uint32 sibling = index;
+    const uint32 old_parent = nodes_[sibling].parent;
+    const uint32 new_parent = allocate_node();
+    nodes_[new_parent].parent = old_parent;
+    nodes_[new_parent].box = Box::merge(box, nodes_[sibling].box);
+    nodes_[new_parent].height = nodes_[sibling].height + 1;
+    nodes_[new_parent].left = sibling;
+    nodes_[new_parent].right = leaf;
+    nodes_[sibling].parent = new_parent;
+    nodes_[leaf].parent = new_parent;
+
+    if (old_parent == kNull) {
+      root_ = new_parent;
+    } else if (nodes_[old_parent].left == sibling) {
+      nodes_[old_parent].left = new_parent;
+    } else {
+      nodes_[old_parent].right = new_parent;
+    }
+
+    refit_ancestors(leaf);
+  }
+
+  void DynamicBvh::remove_leaf(const uint32 leaf) {
+    if (leaf == root_) {
+      root_ = kNull;
+      return;
+    }
+
+    const uint32 parent = nodes_[leaf].parent;
+    const uint32 grand_parent = nodes_[parent].parent;
+    const uint32 sibling = nodes_[parent].left == leaf ? nodes_[parent].right : nodes_[parent].left;
+
+    free_node(parent);
+    nodes_[sibling].parent = grand_parent;
+    if (grand_parent == kNull) {
+      root_ = sibling;
+      return;
+    }
+
+    if (nodes_[grand_parent].left == parent) {
+      nodes_[grand_parent].left = sibling;
+    } else {
+      nodes_[grand_parent].right = sibling;
+    }
+    refit_ancestors(sibling);
+  }
+
+  void DynamicBvh::refit_ancestors(const uint32 node) {
+    for (uint32 index = nodes_[node].parent; index != kNull; index = nodes_[index].parent) {
+      index = balance(index);
+
+      Node& ancestor = nodes_[index];
+      const Node& left = nodes_[ancestor.left];
+      const Node& right = nodes_[ancestor.right];
+      ancestor.height = 1 + std::max(left.height, right.height);
+      ancestor.box = Box::merge(left.box, right.box);
+    }
+  }
+
+  uint32 DynamicBvh::balance(const uint32 a) {
+    // rotates the higher child of a up if the heights of a's children differ by more than one,
+    // returns the node that took a's place
+    Node& node_a = nodes_[a];
+    if (node_a.is_leaf() || node_a.height < 2) {
+      return a;
+    }
+
+    const uint32 b = node_a.left;
+    const uint32 c = node_a.right;
+    const int32 difference = nodes_[c].height - nodes_[b].height;
+    if (std::abs(difference) <= 1) {
+      return a;
+    }
+
+    // the higher child moves up, a takes the lower one and the lower grandchild
+    const uint32 up = difference > 0 ? c : b;
+    const uint32 down = difference > 0 ? b : c;
+    Node& node_up = nodes_[up];
+    const uint32 f = node_up.left;
+    const uint32 g = node_up.right;
+
+    node_up.left = a;
+    node_up.parent = node_a.parent;
+    node_a.parent = up;
+
+    if (node_up.parent == kNull) {
+      root_ = up;
+    } else if (nodes_[node_up.parent].left == a) {
+      nodes_[node_up.parent].left = up;
+    } else {
+      nodes_[node_up.parent].right = up;
+    }
+
+    const bool keep_f = nodes_[f].height > nodes_[g].height;
+    const uint32 kept = keep_f ? f : g;
+    const uint32 moved = keep_f ? g : f;
+
+    node_up.right = kept;
+    if (difference > 0) {
+      node_a.right = moved;
+    } else {
+      node_a.left = moved;
+    }
+    nodes_[moved].parent = a;
+
+    node_a.box = Box::merge(nodes_[down].box, nodes_[moved].box);
+    node_a.height = 1 + std::max(nodes_[down].height, nodes_[moved].height);
+    node_up.box = Box::merge(node_a.box, nodes_[kept].box);
+    node_up.height = 1 + std::max(node_a.height, nodes_[kept].height);
+    return up;
+  }
+
+  void DynamicBvh::rebuild() {
+    if (leaf_count_ < 2) {
+      return;
+    }
+
+    std::vector<uint32> leaves;
+    leaves.reserve(leaf_count_);
+    for (uint32 node = 0; node < nodes_.size(); ++node) {
+      if (nodes_[node].height < 0) {
+        continue;  // free
+      }
+      if (nodes_[node].is_leaf()) {
+        leaves.push_back(node);
+      } else {
+        free_node(node);
+      }
+    }
+
+    centroids_.resize(nodes_.size());
+    for (const uint32 node : leaves) {
+      centroids_[node] = (nodes_[node].box.min + nodes_[node].box.max) * 0.5f;
+    }
+
+    root_ = build(leaves, 0, leaves.size(), 0);
+    nodes_[root_].parent = kNull;
+  }
+
+  uint32 DynamicBvh::build(std::vector<uint32>& leaves, const size_t begin, const size_t end,
+                           const size_t depth) {
+    if (end - begin == 1) {
+      return leaves[begin];
+    }
+
+    const auto centroid = [&](const uint32 node) { return centroids_[node]; };
+
+    Box centroids{centroid(leaves[begin]), centroid(leaves[begin])};
+    for (size_t i = begin + 1; i < end; ++i) {
+      const glm::vec3 point = centroid(leaves[i]);
+      centroids = Box::merge(centroids, {point, point});
+    }
+
+    const glm::vec3 extent = centroids.max - centroids.min;
+    const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+
+    size_t middle = begin + (end - begin) / 2;
+    bool partitioned = false;
+    // SAH splits may peel off a few leaves at a time, past half the height limit the median keeps
+    // the remaining levels at log2 of the at most 2^24 entities
+    if (extent[axis] > 0.f && depth < kMaxHeight / 2) {
+      // binned SAH: sort centroids into buckets and take the cheapest split between buckets
+      constexpr size_t kBins = 12;
+      const float32 scale = static_cast<float32>(kBins) / extent[axis];
+      const auto bin_of = [&](const uint32 node) {
+        const auto bin = static_cast<size_t>((centroid(node)[axis] - centroids.min[axis]) * scale);
+        return std::min(bin, kBins - 1);
+      };
+
+      std::array<Box, kBins> bin_boxes;
+      std::array<size_t, kBins> bin_counts{};
+      for (size_t i = begin; i < end; ++i) {
+        const size_t bin = bin_of(leaves[i]);
+        bin_boxes[bin] = bin_counts[bin] == 0 ? nodes_[leaves[i]].box
+                                              : Box::merge(bin_boxes[bin], nodes_[leaves[i]].box);
+        ++bin_counts[bin];
+      }
+
+      // cost of splitting after bin i, accumulated from both sides
+      std::array<float32, kBins - 1> costs{};
+      Box left_box;
+      size_t left_count = 0;
+      for (size_t i = 0; i < kBins - 1; ++i) {
+        if (bin_counts[i] != 0) {
+          left_box = left_count == 0 ? bin_boxes[i] : Box::merge(left_box, bin_boxes[i]);
+          left_count += bin_counts[i];
+        }
+        costs[i] = left_count != 0 ? left_box.area() * static_cast<float32>(left_count) : 0.f;
+      }
+      Box right_box;
+      size_t right_count = 0;
+      for (size_t i = kBins - 1; i > 0; --i) {
+        if (bin_counts[i] != 0) {
+          right_box = right_count == 0 ? bin_boxes[i] : Box::merge(right_box, bin_boxes[i]);
+          right_count += bin_counts[i];
+        }
+        costs[i - 1] += right_count != 0 ? right_box.area() * static_cast<float32>(right_count) : 0.f;
+      }
+
+      const size_t split = static_cast<size_t>(
+          std::min_element(costs.begin(), costs.end()) - costs.begin());
+      const auto first = leaves.begin() + static_cast<std::ptrdiff_t>(begin);
+      const auto last = leaves.begin() + static_cast<std::ptrdiff_t>(end);
+      const size_t partition = static_cast<size_t>(
+          std::partition(first, last, [&](const uint32 node) { return bin_of(node) <= split; })
+          - leaves.begin());
+      if (partition != begin && partition != end) {
+        middle = partition;
+        partitioned = true;
+      }
+    }
+
+    // split at the median if all centroids ended up on one side
+    if (!partitioned) {
+      std::nth_element(leaves.begin() + static_cast<std::ptrdiff_t>(begin),
+                       leaves.begin() + static_cast<std::ptrdiff_t>(middle),
+                       leaves.begin() + static_cast<std::ptrdiff_t>(end),
+                       [&](const uint32 a, const uint32 b) {
+                         return centroid(a)[axis] < centroid(b)[axis];
+                       });
+    }
+
+    const uint32 left = build(leaves, begin, middle, depth + 1);
+    const uint32 right = build(leaves, middle, end, depth + 1);
+    const uint32 node = allocate_node();
+    nodes_[node].left = left;
+    nodes_[node].right = right;
+    nodes_[node].box = Box::merge(nodes_[left].box, nodes_[right].box);
+    nodes_[node].height = 1 + std::max(nodes_[left].height, nodes_[right].height);
+    nodes_[left].parent = node;
+    nodes_[right].parent = node;
+    return node;
+  }
+
+}  // namespace gestalt::foundation
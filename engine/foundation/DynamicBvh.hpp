@@ -0,0 +1,171 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
+#include <vector>
+
+#include "glm/common.hpp"
+#include "glm/vec3.hpp"
+
+#include "common.hpp"
+#include "Components/Entity.hpp"
+#include "Mesh/AABB.hpp"
+#include "Mesh/Frustum.hpp"
+
+namespace gestalt::foundation {
+
+  /**
+   * \brief Bounding volume hierarchy over world-space boxes of entities.
+   *
+   * Leaves store a box enlarged by kMargin, so an entity that moves a little does not touch the
+   * tree at all. An entity that leaves its box is removed and inserted again, the insertion walks
+   * down to the sibling that adds the least surface area and rotates nodes on the way up to keep
+   * the tree balanced. rebuild() replaces the tree with a binned SAH build over all leaves, which
+   * is the better choice after many insertions, e.g. when a scene was loaded.
+   *
+   * Queries call fn(Entity) for every leaf whose box passes the test. Leaf boxes are enlarged, so
+   * callers that need exact results test the entity's own bounds again.
+   */
+  class DynamicBvh {
+    static constexpr uint32 kNull = std::numeric_limits<uint32>::max();
+    // traversal keeps at most one pending sibling per level, rebuild() keeps the tree below this
+    static constexpr size_t kMaxHeight = 64;
+
+    struct Box {
+      glm::vec3 min{0.f};
+      glm::vec3 max{0.f};
+
+      [[nodiscard]] bool contains(const Box& other) const {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z
+               && other.max.x <= max.x && other.max.y <= max.y && other.max.z <= max.z;
+      }
+
+      [[nodiscard]] bool overlaps(const Box& other) const {
+        return min.x <= other.max.x && other.min.x <= max.x && min.y <= other.max.y
+               && other.min.y <= max.y && min.z <= other.max.z && other.min.z <= max.z;
+      }
+
+      [[nodiscard]] float32 area() const {
+        const glm::vec3 size = max - min;
+        return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+      }
+
+      [[nodiscard]] static Box merge(const Box& a, const Box& b) {
+        return {glm::min(a.min, b.min), glm::max(a.max, b.max)};
+      }
+    };
+
+    struct Node {
+      Box box;
+      uint32 parent = kNull;
+      uint32 left = kNull;
+      uint32 right = kNull;
+      int32 height = 0;  // 0 for leaves
+      Entity entity = invalid_entity;
+
+      [[nodiscard]] bool is_leaf() const { return left == kNull; }
+    };
+
+  public:
+    static constexpr float32 kMargin = 0.1f;
+
+    /** \brief Inserts the entity or moves it to new bounds. Returns true if it was inserted. */
+    bool update(Entity entity, const AABB& bounds);
+    void remove(Entity entity);
+    void clear();
+
+    /** \brief Rebuilds the whole tree top-down with the surface area heuristic. */
+    void rebuild();
+
+    [[nodiscard]] bool contains(const Entity entity) const { return leaf(entity) != kNull; }
+    [[nodiscard]] size_t size() const { return leaf_count_; }
+    [[nodiscard]] int32 height() const { return root_ != kNull ? nodes_[root_].height : 0; }
+
+    template <typename Fn> void query_aabb(const AABB& bounds, Fn&& fn) const {
+      const Box box{bounds.min, bounds.max};
+      traverse([&](const Box& node) { return node.overlaps(box); }, fn);
+    }
+
+    template <typename Fn>
+    void query_sphere(const glm::vec3& center, const float32 radius, Fn&& fn) const {
+      const float32 radius_squared = radius * radius;
+      traverse(
+          [&](const Box& node) {
+            const glm::vec3 offset = center - glm::clamp(center, node.min, node.max);
+            return offset.x * offset.x + offset.y * offset.y + offset.z * offset.z
+                   <= radius_squared;
+          },
+          fn);
+    }
+
+    template <typename Fn> void query_frustum(const Frustum& frustum, Fn&& fn) const {
+      traverse([&](const Box& node) { return frustum.intersects(node.min, node.max); }, fn);
+    }
+
+    /**
+     * \brief Calls fn(Entity, float32 distance) for every leaf box hit by the ray within
+     * max_distance. distance is where the ray enters the leaf box, the calls are not ordered.
+     */
+    template <typename Fn>
+    void query_ray(const glm::vec3& origin, const glm::vec3& direction,
+                   const float32 max_distance, Fn&& fn) const {
+      // a zero direction component would give an infinite inverse and 0 * inf = NaN for boxes
+      // touching the origin's plane, a large finite inverse keeps those slab tests meaningful
+      constexpr float32 kMaxInverse = 1e30f;
+      const glm::vec3 inverse
+          = glm::clamp(1.f / direction, glm::vec3(-kMaxInverse), glm::vec3(kMaxInverse));
+      float32 entry = 0.f;
+      const auto hit = [&](const Box& node) {
+        const glm::vec3 t0 = (node.min - origin) * inverse;
+        const glm::vec3 t1 = (node.max - origin) * inverse;
+        const glm::vec3 near = glm::min(t0, t1);
+        const glm::vec3 far = glm::max(t0, t1);
+        entry = std::max({near.x, near.y, near.z, 0.f});
+        return entry <= std::min({far.x, far.y, far.z, max_distance});
+      };
+      traverse(hit, [&](const Entity entity) { fn(entity, entry); });
+    }
+
+  private:
+    template <typename Test, typename Fn> void traverse(Test&& test, Fn&& fn) const {
+      if (root_ == kNull) {
+        return;
+      }
+      assert(static_cast<size_t>(height()) < kMaxHeight);
+      std::array<uint32, kMaxHeight + 1> stack;
+      size_t size = 0;
+      stack[size++] = root_;
+      while (size != 0) {
+        const Node& node = nodes_[stack[--size]];
+        if (!test(node.box)) {
+          continue;
+        }
+        if (node.is_leaf()) {
+          fn(node.entity);
+        } else {
+          stack[size++] = node.left;
+          stack[size++] = node.right;
+        }
+      }
+    }
+
+    [[nodiscard]] uint32 leaf(Entity entity) const;
+    uint32 allocate_node();
+    void free_node(uint32 node);
+    void insert_leaf(uint32 leaf);
+    void remove_leaf(uint32 leaf);
+    void refit_ancestors(uint32 node);
+    uint32 balance(uint32 node);
+    uint32 build(std::vector<uint32>& leaves, size_t begin, size_t end, size_t depth);
+
+    std::vector<Node> nodes_;
+    std::vector<uint32> leaves_;  // node per entity_index
+    uint32 root_ = kNull;
+    uint32 free_list_ = kNull;    // linked through Node::parent
+    size_t leaf_count_ = 0;
+    std::vector<glm::vec3> centroids_;  // per node, only valid during rebuild
+  };
+
+}  // namespace gestalt::foundation
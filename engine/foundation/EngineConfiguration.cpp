@@ -28,7 +28,8 @@ namespace gestalt::foundation {
                                     {"useVsync", config_.useVsync},
                                     {"enableVulkanRayTracing", config_.enableVulkanRayTracing},
                                     {"useValidationLayers", config_.useValidationLayers},
-                                    {"physicalDeviceIndex", config_.physicalDeviceIndex}};
+                                    {"physicalDeviceIndex", config_.physicalDeviceIndex},
+                                    {"validateSystemAccess", config_.validateSystemAccess}};
 
       std::ofstream out_config_file(filename);
       if (out_config_file) {
@@ -69,6 +70,8 @@ namespace gestalt::foundation {
           = config_json.value("useValidationLayers", config_.useValidationLayers);
       config_.physicalDeviceIndex
           = config_json.value("physicalDeviceIndex", config_.physicalDeviceIndex);
+      config_.validateSystemAccess
+          = config_json.value("validateSystemAccess", config_.validateSystemAccess);
 
     } catch (const nlohmann::json::type_error& e) {
       fmt::println("JSON type error in configuration file: {}", e.what());
@@ -30,6 +30,7 @@ namespace gestalt::foundation {
   constexpr bool kUseVsync = false;
   constexpr bool kUseValidationLayers = false;
   constexpr bool kDefaultEnableVulkanRayTracing = true;
+  constexpr bool kDefaultValidateSystemAccess = false;
 
   struct Config {
     // compile time configuration
@@ -48,6 +49,7 @@ namespace gestalt::foundation {
     bool useVsync = kUseVsync;
     bool enableVulkanRayTracing = kDefaultEnableVulkanRayTracing;
     uint32 physicalDeviceIndex = 0;
+    bool validateSystemAccess = kDefaultValidateSystemAccess;
   };
 
   class EngineConfiguration {
@@ -130,4 +132,7 @@ namespace gestalt::foundation {
   inline uint32 getPhysicalDeviceIndex() {
     return EngineConfiguration::get_instance().get_config().physicalDeviceIndex;
   }
+  inline bool validateSystemAccess() {
+    return EngineConfiguration::get_instance().get_config().validateSystemAccess;
+  }
 }  // namespace gestalt::foundation
\ No newline at end of file
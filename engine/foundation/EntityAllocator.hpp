@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include <cassert>
+#include <deque>
+#include <vector>
+
+#include "common.hpp"
+#include "Components/Entity.hpp"
+
+namespace gestalt::foundation {
+
+  /**
+   * \brief Hands out generational entity handles and recycles the slots of destroyed entities.
+   * Freed slots are only reused once kMinimumFreeSlots of them are queued, which spreads the reuse
+   * over many slots and keeps generations from wrapping around quickly.
+   */
+  class EntityAllocator {
+    static constexpr size_t kMinimumFreeSlots = 1024;
+
+  public:
+    [[nodiscard]] Entity create() {
+      uint32 index;
+      if (free_slots_.size() > kMinimumFreeSlots) {
+        index = free_slots_.front();
+        free_slots_.pop_front();
+      } else {
+        index = static_cast<uint32>(generations_.size());
+        assert(index < kEntityIndexMask && "entity index space exhausted");
+        generations_.push_back(0);
+      }
+      ++alive_;
+      return make_entity(index, generations_[index]);
+    }
+
+    void destroy(const Entity entity) {
+      if (!is_alive(entity)) {
+        return;
+      }
+      const uint32 index = entity_index(entity);
+      generations_[index] = (generations_[index] + 1) & kEntityGenerationMask;
+      free_slots_.push_back(index);
+      --alive_;
+    }
+
+    [[nodiscard]] bool is_alive(const Entity entity) const {
+      const uint32 index = entity_index(entity);
+      return entity != invalid_entity && index < generations_.size()
+             && generations_[index] == entity_generation(entity);
+    }
+
+    [[nodiscard]] size_t alive_count() const { return alive_; }
+    [[nodiscard]] size_t capacity() const { return generations_.size(); }
+
+  private:
+    std::vector<uint32> generations_;
+    std::deque<uint32> free_slots_;
+    size_t alive_ = 0;
+  };
+
+}  // namespace gestalt::foundation
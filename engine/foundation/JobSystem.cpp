@@ -0,0 +1,156 @@
+﻿#include "JobSystem.hpp"
+
+namespace gestalt::foundation {
+
+  namespace {
+    thread_local const JobSystem* tls_owner = nullptr;
+    thread_local uint32 tls_queue = 0;
+  }  // namespace
+
+  JobSystem::JobSystem(const uint32 worker_count) {
+    queues_.reserve(worker_count + 1);
+    for (uint32 i = 0; i <= worker_count; ++i) {
+      queues_.push_back(std::make_unique<WorkQueue>());
+    }
+
+    workers_.reserve(worker_count);
+    for (uint32 i = 0; i < worker_count; ++i) {
+      workers_.emplace_back([this, queue = i + 1] { worker_loop(queue); });
+    }
+  }
+
+  JobSystem::~JobSystem() {
+    {
+      std::lock_guard lock(sleep_mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    workers_.clear();  // joins, workers drain the queues first
+  }
+
+  void JobSystem::schedule(Job job, JobCounter* counter) {
+    if (counter != nullptr) {
+      counter->pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+    push({std::move(job), counter});
+  }
+
+  void JobSystem::schedule_after(JobCounter& dependency, Job job, JobCounter* counter) {
+    if (counter != nullptr) {
+      counter->pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+      std::lock_guard lock(dependency.mutex_);
+      if (dependency.pending_.load(std::memory_order_acquire) != 0) {
+        dependency.continuations_.push_back({std::move(job), counter});
+        return;
+      }
+    }
+    push({std::move(job), counter});
+  }
+
+  void JobSystem::wait(JobCounter& counter) {
+    while (!counter.is_done()) {
+      if (!try_run_one()) {
+        std::this_thread::yield();
+      }
+    }
+    // the last job releases the counter while holding its mutex, the counter may be destroyed
+    // once that job let go of it
+    std::lock_guard lock(counter.mutex_);
+  }
+
+  uint32 JobSystem::current_queue() const { return tls_owner == this ? tls_queue : 0; }
+
+  void JobSystem::push(Task task) {
+    // counted before it is visible, a thief that takes it right away must not drive queued_ below
+    // zero
+    queued_.fetch_add(1);
+    WorkQueue& queue = *queues_[current_queue()];
+    {
+      std::lock_guard lock(queue.mutex);
+      queue.tasks.push_back(std::move(task));
+    }
+
+    if (sleeping_.load() > 0) {
+      std::lock_guard lock(sleep_mutex_);
+      wake_.notify_one();
+    }
+  }
+
+  bool JobSystem::pop(const uint32 queue, Task& task) {
+    WorkQueue& work_queue = *queues_[queue];
+    std::lock_guard lock(work_queue.mutex);
+    if (work_queue.tasks.empty()) {
+      return false;
+    }
+    task = std::move(work_queue.tasks.back());
+    work_queue.tasks.pop_back();
+    return true;
+  }
+
+  bool JobSystem::steal(const uint32 thief, Task& task) {
+    const auto queue_count = static_cast<uint32>(queues_.size());
+    for (uint32 offset = 1; offset < queue_count; ++offset) {
+      WorkQueue& victim = *queues_[(thief + offset) % queue_count];
+      std::lock_guard lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool JobSystem::try_run_one() {
+    const uint32 queue = current_queue();
+    Task task;
+    if (!pop(queue, task) && !steal(queue, task)) {
+      return false;
+    }
+    queued_.fetch_sub(1);
+    run(task);
+    return true;
+  }
+
+  void JobSystem::run(Task& task) {
+    task.job();
+
+    JobCounter* counter = task.counter;
+    if (counter == nullptr) {
+      return;
+    }
+
+    std::vector<JobCounter::Continuation> ready;
+    {
+      std::lock_guard lock(counter->mutex_);
+      if (counter->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        ready.swap(counter->continuations_);
+      }
+    }
+    for (auto& [job, continuation_counter] : ready) {
+      push({std::move(job), continuation_counter});
+    }
+  }
+
+  void JobSystem::worker_loop(const uint32 queue) {
+    tls_owner = this;
+    tls_queue = queue;
+
+    while (true) {
+      if (try_run_one()) {
+        continue;
+      }
+
+      std::unique_lock lock(sleep_mutex_);
+      sleeping_.fetch_add(1);
+      wake_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+      sleeping_.fetch_sub(1);
+      if (stop_ && queued_.load() == 0) {
+        return;
+      }
+    }
+  }
+
+}  // namespace gestalt::foundation
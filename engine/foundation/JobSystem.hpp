@@ -0,0 +1,135 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common.hpp"
+
+namespace gestalt::foundation {
+
+  using Job = std::function<void()>;
+
+  /**
+   * \brief Counts the unfinished jobs that were scheduled against it. Jobs scheduled with
+   * schedule_after on a counter start once it drops to zero. A counter must outlive its jobs, so
+   * wait on it before it goes out of scope.
+   */
+  class JobCounter final {
+    struct Continuation {
+      Job job;
+      JobCounter* counter;
+    };
+
+    std::atomic<uint32> pending_{0};
+    std::mutex mutex_;
+    std::vector<Continuation> continuations_;
+
+    friend class JobSystem;
+
+  public:
+    JobCounter() = default;
+    ~JobCounter() = default;
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    JobCounter(JobCounter&&) = delete;
+    JobCounter& operator=(JobCounter&&) = delete;
+
+    [[nodiscard]] bool is_done() const { return pending_.load(std::memory_order_acquire) == 0; }
+  };
+
+  /**
+   * \brief Work-stealing job system shared by the engine.
+   *
+   * Every worker owns a deque: it pushes and pops its own jobs at the back and steals from the
+   * front of the other deques when it runs dry. Threads that are not workers share one extra deque.
+   * The deques are std::deques guarded by one mutex each, not lock-free; the owner and a thief
+   * only contend when they meet on the same deque.
+   * Idle workers sleep until new jobs are queued. A thread that waits on a counter keeps executing
+   * jobs until the counter is done, so waiting from inside a job never blocks a worker.
+   *
+   * Jobs must not throw.
+   */
+  class JobSystem final {
+    struct Task {
+      Job job;
+      JobCounter* counter;
+    };
+
+    struct WorkQueue {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;  // [0] is shared by non-worker threads
+    std::vector<std::jthread> workers_;
+
+    std::atomic<uint32> queued_{0};
+    std::atomic<uint32> sleeping_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+
+    void push(Task task);
+    bool pop(uint32 queue, Task& task);
+    bool steal(uint32 thief, Task& task);
+    bool try_run_one();
+    void run(Task& task);
+    void worker_loop(uint32 queue);
+    [[nodiscard]] uint32 current_queue() const;
+
+  public:
+    explicit JobSystem(uint32 worker_count = default_worker_count());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+
+    /** \brief One worker per hardware thread, leaving one for the main thread. */
+    static uint32 default_worker_count() {
+      return std::max(1u, std::thread::hardware_concurrency()) - 1;
+    }
+
+    [[nodiscard]] uint32 worker_count() const { return static_cast<uint32>(workers_.size()); }
+
+    /** \brief Queues a job, counter (if given) is decremented once the job finished. */
+    void schedule(Job job, JobCounter* counter = nullptr);
+
+    /** \brief Queues a job once dependency is done. */
+    void schedule_after(JobCounter& dependency, Job job, JobCounter* counter = nullptr);
+
+    /** \brief Executes queued jobs on the calling thread until the counter is done. */
+    void wait(JobCounter& counter);
+
+    /**
+     * \brief Calls fn(begin, end) for consecutive ranges of at most batch_size indices covering
+     * [0, count) and returns when all of them finished. The calling thread takes the first batch.
+     */
+    template <typename Fn> void parallel_for(const uint32 count, const uint32 batch_size, Fn&& fn) {
+      if (count == 0) {
+        return;
+      }
+      const uint32 batch = std::max(1u, batch_size);
+
+      JobCounter counter;
+      for (uint32 begin = batch; begin < count; begin += batch) {
+        const uint32 end = std::min(count, begin + batch);
+        schedule([&fn, begin, end] { fn(begin, end); }, &counter);
+      }
+      fn(0u, std::min(count, batch));
+      wait(counter);
+    }
+  };
+
+}  // namespace gestalt::foundation
@@ -0,0 +1,53 @@
+﻿#pragma once
+
+#include <array>
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "glm/geometric.hpp"
+
+#include "common.hpp"
+
+namespace gestalt::foundation {
+
+  /**
+   * \brief Six planes with normals pointing inwards, a point p is inside if
+   * dot(plane.xyz, p) + plane.w >= 0 holds for all of them.
+   */
+  struct Frustum {
+    std::array<glm::vec4, 6> planes;
+
+    /** \brief Extracts the planes of a view projection matrix with a [0, 1] depth range. */
+    static Frustum from_matrix(const glm::mat4& view_projection) {
+      const glm::vec4 row0{view_projection[0][0], view_projection[1][0], view_projection[2][0],
+                           view_projection[3][0]};
+      const glm::vec4 row1{view_projection[0][1], view_projection[1][1], view_projection[2][1],
+                           view_projection[3][1]};
+      const glm::vec4 row2{view_projection[0][2], view_projection[1][2], view_projection[2][2],
+                           view_projection[3][2]};
+      const glm::vec4 row3{view_projection[0][3], view_projection[1][3], view_projection[2][3],
+                           view_projection[3][3]};
+
+      Frustum frustum{{row3 + row0, row3 - row0, row3 + row1, row3 - row1, row2, row3 - row2}};
+      for (auto& plane : frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+      }
+      return frustum;
+    }
+
+    /** \brief Conservative test, may report boxes outside near the frustum corners. */
+    [[nodiscard]] bool intersects(const glm::vec3& min, const glm::vec3& max) const {
+      for (const auto& plane : planes) {
+        // the box corner furthest along the plane normal
+        const glm::vec3 corner{plane.x >= 0.f ? max.x : min.x, plane.y >= 0.f ? max.y : min.y,
+                               plane.z >= 0.f ? max.z : min.z};
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.f) {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+
+}  // namespace gestalt::foundation
@@ -2,8 +2,15 @@
 
 #include <memory>
 #include <optional>
-#include <unordered_map>
-
+#include <type_traits>
+
+#include "ComponentRegistry.hpp"
+#include "ComponentStorage.hpp"
+#include "ComponentView.hpp"
+#include "DynamicBvh.hpp"
+#include "EntityAllocator.hpp"
+#include "SceneHierarchy.hpp"
+#include "StringTable.hpp"
 #include "Buffer/LightBuffer.hpp"
 #include "Buffer/MaterialBuffer.hpp"
 #include "Buffer/MeshBuffer.hpp"
@@ -15,15 +22,18 @@
 #include "Components/Entity.hpp"
 #include "Components/FirstPersonCameraComponent.hpp"
 #include "Components/FreeFlyCameraComponent.hpp"
+#include "Components/HiddenComponent.hpp"
 #include "Components/MeshComponent.hpp"
 #include "Components/NodeComponent.hpp"
 #include "Components/OrbitCameraComponent.hpp"
 #include "Components/OrthographicProjectionComponent.hpp"
 #include "Components/PerspectiveProjectionComponent.hpp"
 #include "Components/TransformComponent.hpp"
+#include "Components/WorldTransformComponent.hpp"
 #include "Components/PhysicsComponent.hpp"
 #include "Components/PointLightComponent.hpp"
 #include "Components/SpotLightComponent.hpp"
+#include "Components/StaticComponent.hpp"
 #include "Material/Material.hpp"
 #include "Mesh/Mesh.hpp"
 #include "Mesh/MeshDraw.hpp"
@@ -37,39 +47,6 @@
 
 namespace gestalt::foundation {
 
-  template <typename ComponentType> class ComponentStorage {
-  public:
-    [[nodiscard]] const ComponentType* find(Entity ent) const {
-      auto it = components_.find(ent);
-      return (it != components_.end()) ? &it->second : nullptr;
-    }
-
-    [[nodiscard]] ComponentType* find_mutable(Entity ent) {
-      auto it = components_.find(ent);
-      return (it != components_.end()) ? &it->second : nullptr;
-    }
-
-    void upsert(Entity ent, const ComponentType& component) {
-      components_.insert_or_assign(ent, component);
-    }
-
-    void remove(Entity ent) { components_.erase(ent); }
-
-    [[nodiscard]] std::vector<std::pair<Entity, ComponentType>> snapshot() const {
-      std::vector<std::pair<Entity, ComponentType>> result;
-      result.reserve(components_.size());
-      for (auto& [ent, comp] : components_) {
-        result.emplace_back(ent, comp);  // copy
-      }
-      return result;
-    }
-
-    [[nodiscard]] size_t size() const { return components_.size(); }
-
-  private:
-    std::unordered_map<Entity, ComponentType> components_;
-  };
-
   template <typename DataType> class GpuDataContainer {
   public:
     size_t size() const { return data_.size(); }
@@ -159,22 +136,70 @@ namespace gestalt::foundation {
 
     std::vector<MeshDraw> mesh_draws_; ///actual one, super cursed i know
 
-    ComponentStorage<NodeComponent> scene_graph;
-    ComponentStorage<MeshComponent> mesh_components;
-
-    ComponentStorage<AnimationCameraComponent> animation_camera_components;
-    ComponentStorage<FirstPersonCameraComponent> first_person_camera_components;
-    ComponentStorage<FreeFlyCameraComponent> free_fly_camera_components;
-    ComponentStorage<OrbitCameraComponent> orbit_camera_components;
-    ComponentStorage<PerspectiveProjectionComponent> perspective_projection_components;
-    ComponentStorage<OrthographicProjectionComponent> orthographic_projection_components;
-
-    ComponentStorage<DirectionalLightComponent> directional_light_components;
-    ComponentStorage<PointLightComponent> point_light_components;
-    ComponentStorage<SpotLightComponent> spot_light_components;
+    EntityAllocator entity_allocator;
+
+    StringTable names;
+    SceneHierarchy scene_hierarchy;
+    // world bounds of mesh entities, kept in sync by the TransformSystem; queries visit both
+    DynamicBvh scene_bvh;   // movable entities
+    DynamicBvh static_bvh;  // entities tagged with StaticComponent
+
+    ComponentRegistry<NodeComponent, MeshComponent, AnimationCameraComponent,
+                      FirstPersonCameraComponent, FreeFlyCameraComponent, OrbitCameraComponent,
+                      PerspectiveProjectionComponent, OrthographicProjectionComponent,
+                      DirectionalLightComponent, PointLightComponent, SpotLightComponent,
+                      AnimationComponent, TransformComponent, PhysicsComponent, HiddenComponent,
+                      StaticComponent>
+        components;
+
+    // named shortcuts into components
+    StorageOf<NodeComponent>& scene_graph = components.storage<NodeComponent>();
+    StorageOf<MeshComponent>& mesh_components = components.storage<MeshComponent>();
+
+    StorageOf<AnimationCameraComponent>& animation_camera_components
+        = components.storage<AnimationCameraComponent>();
+    StorageOf<FirstPersonCameraComponent>& first_person_camera_components
+        = components.storage<FirstPersonCameraComponent>();
+    StorageOf<FreeFlyCameraComponent>& free_fly_camera_components
+        = components.storage<FreeFlyCameraComponent>();
+    StorageOf<OrbitCameraComponent>& orbit_camera_components
+        = components.storage<OrbitCameraComponent>();
+    StorageOf<PerspectiveProjectionComponent>& perspective_projection_components
+        = components.storage<PerspectiveProjectionComponent>();
+    StorageOf<OrthographicProjectionComponent>& orthographic_projection_components
+        = components.storage<OrthographicProjectionComponent>();
+
+    StorageOf<DirectionalLightComponent>& directional_light_components
+        = components.storage<DirectionalLightComponent>();
+    StorageOf<PointLightComponent>& point_light_components
+        = components.storage<PointLightComponent>();
+    StorageOf<SpotLightComponent>& spot_light_components = components.storage<SpotLightComponent>();
+
+    StorageOf<AnimationComponent>& animation_components = components.storage<AnimationComponent>();
+    StorageOf<TransformComponent>& transform_components = components.storage<TransformComponent>();
+    StorageOf<PhysicsComponent>& physics_components = components.storage<PhysicsComponent>();
+    StorageOf<HiddenComponent>& hidden_components = components.storage<HiddenComponent>();
+    StorageOf<StaticComponent>& static_components = components.storage<StaticComponent>();
+
+    /** \brief Removes every component owned by the entity. */
+    void remove_components(const Entity entity) { components.remove(entity); }
+
+    /** \brief Opens a new change window on every storage; called once at the start of a frame. */
+    void advance_change_windows() { components.advance_change_windows(); }
+
+    /** \brief Returns the storage that holds components of type T. */
+    template <typename T> [[nodiscard]] StorageOf<T>& storage() { return components.storage<T>(); }
+
+    template <typename T> [[nodiscard]] const StorageOf<T>& storage() const {
+      return components.storage<T>();
+    }
 
-    ComponentStorage<AnimationComponent> animation_components;
-    ComponentStorage<TransformComponent> transform_components;
-    ComponentStorage<PhysicsComponent> physics_components;
+    /**
+     * \brief Joins the storages of all given component types, e.g.
+     * view<const TransformComponent, MeshComponent>().for_each([](Entity, auto& t, auto& m) {}).
+     */
+    template <typename... Components> [[nodiscard]] ComponentView<Components...> view() {
+      return ComponentView<Components...>(storage<std::remove_const_t<Components>>()...);
+    }
   };
 }  // namespace gestalt::foundation
\ No newline at end of file
@@ -0,0 +1,400 @@
+﻿#pragma once
+
+#include <cassert>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+#include "Components/Entity.hpp"
+#include "Components/WorldTransformComponent.hpp"
+
+namespace gestalt::foundation {
+
+  /**
+   * \brief Scene graph flattened into one array per depth.
+   *
+   * Every node sits in the level of its depth and stores the slot of its parent in the level
+   * above, so walking the levels front to back visits parents before their children and a parent
+   * is resolved by index instead of by entity lookup. World transforms are kept next to the nodes
+   * for that reason. Nodes without a parent form level 0. The children of a node are linked
+   * through slots in the level below, so they can be visited without scanning that level.
+   *
+   * Inserting appends to a level, removing swaps the last node of the level into the hole. Leaves
+   * are moved in O(1) apart from the fix-up of the moved node's children. Reparenting is
+   * O(size of the subtree): every node of the subtree changes depth, so each one is taken out of
+   * its level and appended to the new one.
+   *
+   * This is an index over the NodeComponent links, not a replacement for them. Slots change
+   * whenever a level is compacted, so they cannot serve as identities for the editor, for
+   * destruction or for prefab copies, which all walk the entity-keyed links. The links in turn
+   * have no depth order for the transform passes. Both are updated together by the
+   * ComponentFactory.
+   */
+  class SceneHierarchy {
+    static constexpr uint32 kNone = std::numeric_limits<uint32>::max();
+
+    struct Location {
+      uint32 depth = kNone;
+      uint32 slot = kNone;
+    };
+
+  public:
+    struct Level {
+      std::vector<Entity> entities;
+      std::vector<uint32> parents;  // slot in the level above, kNone in level 0
+      std::vector<uint32> child_counts;
+      std::vector<uint32> first_children;     // slot in the level below
+      std::vector<uint32> next_siblings;      // slot in the same level
+      std::vector<uint32> previous_siblings;  // slot in the same level
+      std::vector<WorldTransformComponent> world_transforms;
+
+      [[nodiscard]] size_t size() const { return entities.size(); }
+    };
+
+    static constexpr uint32 kNoParent = kNone;
+    static constexpr uint32 kNoSlot = kNone;
+
+    /** \brief Calls fn(uint32 child_slot) for every child of the node at depth and slot. */
+    template <typename Fn> void for_each_child(const uint32 depth, const uint32 slot, Fn&& fn) const {
+      if (depth + 1 >= levels_.size()) {
+        return;
+      }
+      const Level& child_level = levels_[depth + 1];
+      for (uint32 child = levels_[depth].first_children[slot]; child != kNone;
+           child = child_level.next_siblings[child]) {
+        fn(child);
+      }
+    }
+
+    /** \brief Adds a node without a parent. */
+    void insert(const Entity entity) {
+      assert(!contains(entity) && "entity is already part of the hierarchy");
+      append(entity, 0, kNone);
+    }
+
+    /** \brief Adds a node as the newest child of parent, which must be part of the hierarchy. */
+    void insert(const Entity entity, const Entity parent) {
+      assert(!contains(entity) && "entity is already part of the hierarchy");
+      assert(contains(parent) && "parent is not part of the hierarchy");
+      append_under(entity, parent);
+    }
+
+    /**
+     * \brief Moves the entity and its subtree below parent, or to level 0 for invalid_entity.
+     * Returns false if parent is unknown or part of the entity's own subtree.
+     */
+    bool set_parent(const Entity entity, const Entity parent) {
+      assert(contains(entity) && "entity is not part of the hierarchy");
+      if (parent != invalid_entity && (!contains(parent) || is_in_subtree(parent, entity))) {
+        return false;
+      }
+
+      subtree_.clear();
+      subtree_.emplace_back(entity, parent);
+      collect_descendants(subtree_);
+
+      // deepest nodes first, so every removed node is a leaf
+      for (auto it = subtree_.rbegin(); it != subtree_.rend(); ++it) {
+        remove_leaf(it->first);
+      }
+      for (const auto& [node, node_parent] : subtree_) {
+        append_under(node, node_parent);
+      }
+      return true;
+    }
+
+    /** \brief Removes the entity, its children become nodes without a parent. */
+    void remove(const Entity entity) {
+      if (!contains(entity)) {
+        return;
+      }
+
+      // moving a child only touches deeper levels, but it may resize levels_
+      while (true) {
+        const auto [depth, slot] = locations_[entity_index(entity)];
+        const uint32 child = levels_[depth].first_children[slot];
+        if (child == kNone) {
+          break;
+        }
+        set_parent(levels_[depth + 1].entities[child], invalid_entity);
+      }
+      remove_leaf(entity);
+    }
+
+    [[nodiscard]] bool contains(const Entity entity) const {
+      const uint32 index = entity_index(entity);
+      if (index >= locations_.size() || locations_[index].depth == kNone) {
+        return false;
+      }
+      const auto [depth, slot] = locations_[index];
+      return levels_[depth].entities[slot] == entity;
+    }
+
+    [[nodiscard]] uint32 depth(const Entity entity) const {
+      assert(contains(entity));
+      return locations_[entity_index(entity)].depth;
+    }
+
+    [[nodiscard]] uint32 slot(const Entity entity) const {
+      assert(contains(entity));
+      return locations_[entity_index(entity)].slot;
+    }
+
+    [[nodiscard]] size_t level_count() const { return levels_.size(); }
+    [[nodiscard]] const Level& level(const uint32 depth) const { return levels_[depth]; }
+    [[nodiscard]] std::span<const Level> levels() const { return levels_; }
+
+    /** \brief World transforms of one level, index-aligned with its entities. */
+    [[nodiscard]] std::span<WorldTransformComponent> world_transforms(const uint32 depth) {
+      return levels_[depth].world_transforms;
+    }
+
+    [[nodiscard]] const WorldTransformComponent* world_transform(const Entity entity) const {
+      if (!contains(entity)) {
+        return nullptr;
+      }
+      const auto [depth, slot] = locations_[entity_index(entity)];
+      return &levels_[depth].world_transforms[slot];
+    }
+
+    /**
+     * \brief Records that the world transform of the entity was recomputed. The list covers one
+     * transform pass and is cleared at the start of the next one.
+     */
+    void mark_moved(const Entity entity) { moved_.push_back(entity); }
+    void clear_moved() { moved_.clear(); }
+
+    /** \brief Entities whose world transform changed in the last transform pass. */
+    [[nodiscard]] std::span<const Entity> moved() const { return moved_; }
+
+    /**
+     * \brief Records that the bounds of the entity must be refit although its transform did not
+     * change, e.g. because it lost a child. The next transform pass refits it and its ancestors
+     * without recomputing any world transform.
+     */
+    void invalidate_bounds(const Entity entity) { stale_bounds_.push_back(entity); }
+    void clear_stale_bounds() { stale_bounds_.clear(); }
+
+    /** \brief Entities passed to invalidate_bounds since the last clear_stale_bounds. */
+    [[nodiscard]] std::span<const Entity> stale_bounds() const { return stale_bounds_; }
+
+    /** \brief Parent of the entity, invalid_entity for nodes in level 0. */
+    [[nodiscard]] Entity parent(const Entity entity) const {
+      assert(contains(entity));
+      const auto [depth, slot] = locations_[entity_index(entity)];
+      const uint32 parent_slot = levels_[depth].parents[slot];
+      return parent_slot != kNone ? levels_[depth - 1].entities[parent_slot] : invalid_entity;
+    }
+
+    /**
+     * \brief Calls fn(Entity, const WorldTransformComponent& world) level by level. A node for which
+     * visit(Entity) returns false is skipped together with its whole subtree. Not const, the walk
+     * keeps its scratch buffers between calls.
+     */
+    template <typename Visit, typename Fn> void traverse(Visit&& visit, Fn&& fn) {
+      parent_visited_.clear();
+      for (const Level& level : levels_) {
+        visited_.assign(level.size(), 0);
+        for (size_t slot = 0; slot < level.size(); ++slot) {
+          const uint32 parent = level.parents[slot];
+          if (parent != kNone && !parent_visited_[parent]) {
+            continue;
+          }
+          const Entity entity = level.entities[slot];
+          if (!visit(entity)) {
+            continue;
+          }
+          visited_[slot] = 1;
+          fn(entity, level.world_transforms[slot]);
+        }
+        std::swap(parent_visited_, visited_);
+      }
+    }
+
+    /**
+     * \brief Calls fn(Entity, const WorldTransformComponent& world, bool inherited) for the entity
+     * and every node below it, parents before their children. The entity inherits the given flag,
+     * every other node the flag fn returned for its parent. Costs O(size of the subtree).
+     */
+    template <typename Fn>
+    void traverse_subtree(const Entity entity, const bool inherited, Fn&& fn) {
+      if (!contains(entity)) {
+        return;
+      }
+      const auto [root_depth, root_slot] = locations_[entity_index(entity)];
+      walk_.clear();
+      walk_.push_back({root_depth, root_slot, inherited});
+      while (!walk_.empty()) {
+        const Walk node = walk_.back();
+        walk_.pop_back();
+        const Level& level = levels_[node.depth];
+        const bool passed_on
+            = fn(level.entities[node.slot], level.world_transforms[node.slot], node.inherited);
+        for_each_child(node.depth, node.slot, [&](const uint32 child) {
+          walk_.push_back({node.depth + 1, child, passed_on});
+        });
+      }
+    }
+
+  private:
+    struct Walk {
+      uint32 depth;
+      uint32 slot;
+      bool inherited;
+    };
+
+    void append(const Entity entity, const uint32 depth, const uint32 parent_slot) {
+      if (depth >= levels_.size()) {
+        levels_.resize(depth + 1);
+      }
+
+      Level& level = levels_[depth];
+      const uint32 index = entity_index(entity);
+      if (index >= locations_.size()) {
+        locations_.resize(index + 1);
+      }
+      locations_[index] = {depth, static_cast<uint32>(level.entities.size())};
+
+      const auto slot = static_cast<uint32>(level.entities.size());
+      level.entities.push_back(entity);
+      level.parents.push_back(parent_slot);
+      level.child_counts.push_back(0);
+      level.first_children.push_back(kNone);
+      level.next_siblings.push_back(kNone);
+      level.previous_siblings.push_back(kNone);
+      level.world_transforms.emplace_back();
+
+      if (parent_slot != kNone) {
+        Level& parent_level = levels_[depth - 1];
+        ++parent_level.child_counts[parent_slot];
+
+        const uint32 next = parent_level.first_children[parent_slot];
+        level.next_siblings[slot] = next;
+        if (next != kNone) {
+          level.previous_siblings[next] = slot;
+        }
+        parent_level.first_children[parent_slot] = slot;
+      }
+    }
+
+    void append_under(const Entity entity, const Entity parent) {
+      if (parent == invalid_entity) {
+        append(entity, 0, kNone);
+        return;
+      }
+      const auto [depth, slot] = locations_[entity_index(parent)];
+      append(entity, depth + 1, slot);
+    }
+
+    void remove_leaf(const Entity entity) {
+      Location& location = locations_[entity_index(entity)];
+      const auto [depth, slot] = location;
+      Level& level = levels_[depth];
+      assert(level.child_counts[slot] == 0 && "only leaves can be removed");
+
+      unlink(depth, slot);
+      if (level.parents[slot] != kNone) {
+        --levels_[depth - 1].child_counts[level.parents[slot]];
+      }
+
+      const uint32 last = static_cast<uint32>(level.entities.size() - 1);
+      if (slot != last) {
+        const Entity moved = level.entities[last];
+        level.entities[slot] = moved;
+        level.parents[slot] = level.parents[last];
+        level.child_counts[slot] = level.child_counts[last];
+        level.first_children[slot] = level.first_children[last];
+        level.next_siblings[slot] = level.next_siblings[last];
+        level.previous_siblings[slot] = level.previous_siblings[last];
+        level.world_transforms[slot] = level.world_transforms[last];
+        locations_[entity_index(moved)].slot = slot;
+        relink(depth, last, slot);
+      }
+
+      level.entities.pop_back();
+      level.parents.pop_back();
+      level.child_counts.pop_back();
+      level.first_children.pop_back();
+      level.next_siblings.pop_back();
+      level.previous_siblings.pop_back();
+      level.world_transforms.pop_back();
+      location = {};
+
+      while (!levels_.empty() && levels_.back().entities.empty()) {
+        levels_.pop_back();
+      }
+    }
+
+    /** \brief Takes the node out of its parent's child list. */
+    void unlink(const uint32 depth, const uint32 slot) {
+      Level& level = levels_[depth];
+      const uint32 previous = level.previous_siblings[slot];
+      const uint32 next = level.next_siblings[slot];
+      if (previous != kNone) {
+        level.next_siblings[previous] = next;
+      } else if (level.parents[slot] != kNone) {
+        levels_[depth - 1].first_children[level.parents[slot]] = next;
+      }
+      if (next != kNone) {
+        level.previous_siblings[next] = previous;
+      }
+    }
+
+    /** \brief Points the links of siblings, parent and children of a moved node to its new slot. */
+    void relink(const uint32 depth, const uint32 from, const uint32 to) {
+      Level& level = levels_[depth];
+      if (const uint32 previous = level.previous_siblings[to]; previous != kNone) {
+        level.next_siblings[previous] = to;
+      } else if (level.parents[to] != kNone) {
+        levels_[depth - 1].first_children[level.parents[to]] = to;
+      }
+      if (const uint32 next = level.next_siblings[to]; next != kNone) {
+        level.previous_siblings[next] = to;
+      }
+      if (level.first_children[to] != kNone) {
+        Level& child_level = levels_[depth + 1];
+        for (uint32 child = level.first_children[to]; child != kNone;
+             child = child_level.next_siblings[child]) {
+          assert(child_level.parents[child] == from);
+          child_level.parents[child] = to;
+        }
+      }
+    }
+
+    /**
+     * \brief Appends (node, parent) pairs for the descendants of every node in subtree. Breadth
+     * first, so a subtree that starts with its root stays in depth order.
+     */
+    void collect_descendants(std::vector<std::pair<Entity, Entity>>& subtree) const {
+      for (size_t i = 0; i < subtree.size(); ++i) {
+        const Entity node = subtree[i].first;
+        const auto [depth, slot] = locations_[entity_index(node)];
+        for_each_child(depth, slot, [&](const uint32 child) {
+          subtree.emplace_back(levels_[depth + 1].entities[child], node);
+        });
+      }
+    }
+
+    [[nodiscard]] bool is_in_subtree(const Entity node, const Entity ancestor) const {
+      auto [depth, slot] = locations_[entity_index(node)];
+      const auto [ancestor_depth, ancestor_slot] = locations_[entity_index(ancestor)];
+      while (depth > ancestor_depth) {
+        slot = levels_[depth].parents[slot];
+        --depth;
+      }
+      return depth == ancestor_depth && slot == ancestor_slot;
+    }
+
+    std::vector<Level> levels_;
+    std::vector<Location> locations_;  // indexed by entity_index
+    std::vector<Entity> moved_;
+    std::vector<Entity> stale_bounds_;
+    std::vector<std::pair<Entity, Entity>> subtree_;  // scratch of set_parent, keeps its capacity
+    std::vector<uint8> visited_;                      // scratch of traverse
+    std::vector<uint8> parent_visited_;
+    std::vector<Walk> walk_;                          // scratch of traverse_subtree
+  };
+
+}  // namespace gestalt::foundation
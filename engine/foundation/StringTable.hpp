@@ -0,0 +1,94 @@
+﻿#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "common.hpp"
+
+namespace gestalt::foundation {
+
+  using StringId = uint32;
+
+  /**
+   * \brief Interns strings and hands out small ids for them. Equal strings share one id and one
+   * copy. The characters are kept null-terminated in large blocks that are never moved, so
+   * interning a name costs no allocation of its own and views stay valid until clear().
+   */
+  class StringTable {
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+  public:
+    static constexpr StringId kEmpty = 0;
+
+    StringTable() { strings_.emplace_back(""); }
+
+    [[nodiscard]] StringId intern(const std::string_view string) {
+      if (string.empty()) {
+        return kEmpty;
+      }
+      if (const auto it = ids_.find(string); it != ids_.end()) {
+        return it->second;
+      }
+
+      const std::string_view stored = store(string);
+      const auto id = static_cast<StringId>(strings_.size());
+      strings_.push_back(stored);
+      ids_.emplace(stored, id);
+      return id;
+    }
+
+    /** \brief Returns the id of the string or kEmpty if it was never interned. */
+    [[nodiscard]] StringId find(const std::string_view string) const {
+      const auto it = ids_.find(string);
+      return it != ids_.end() ? it->second : kEmpty;
+    }
+
+    [[nodiscard]] std::string_view view(const StringId id) const {
+      assert(id < strings_.size());
+      return strings_[id];
+    }
+
+    [[nodiscard]] const char* c_str(const StringId id) const { return view(id).data(); }
+
+    [[nodiscard]] size_t size() const { return strings_.size(); }
+
+    void clear() {
+      blocks_.clear();
+      large_blocks_.clear();
+      block_used_ = kBlockSize;
+      strings_.resize(1);
+      ids_.clear();
+    }
+
+  private:
+    std::string_view store(const std::string_view string) {
+      const size_t length = string.size() + 1;
+      char* target;
+      if (length > kBlockSize) {
+        // oversized strings get a block of their own, the current block stays open
+        target = large_blocks_.emplace_back(std::make_unique<char[]>(length)).get();
+      } else {
+        if (block_used_ + length > kBlockSize) {
+          blocks_.emplace_back(std::make_unique<char[]>(kBlockSize));
+          block_used_ = 0;
+        }
+        target = blocks_.back().get() + block_used_;
+        block_used_ += length;
+      }
+      std::memcpy(target, string.data(), string.size());
+      target[string.size()] = '\0';
+      return {target, string.size()};
+    }
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    std::vector<std::unique_ptr<char[]>> large_blocks_;
+    size_t block_used_ = kBlockSize;  // of the last block
+    std::vector<std::string_view> strings_;
+    std::unordered_map<std::string_view, StringId> ids_;
+  };
+
+}  // namespace gestalt::foundation
@@ -0,0 +1,138 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <vector>
+
+#include "common.hpp"
+#include "ComponentIndex.hpp"
+#include "Components/Entity.hpp"
+
+namespace gestalt::foundation {
+
+  /**
+   * \brief Storage for tag components, i.e. empty types whose presence is the information. One bit
+   * and the generation of the tagged handle per entity index. A set bit only answers for the
+   * generation that set it, so stale handles neither see nor change the tag of a recycled slot, and
+   * a later generation takes over a bit an earlier one left behind. Tags are still removed when
+   * their entity is destroyed; Repository::remove_components does that for every registered tag.
+   *
+   * Every add and remove bumps the version and is logged, so systems can visit the entities whose
+   * tag changed since the version they last saw. Like the log of ComponentStorage it keeps at least
+   * one full change window.
+   */
+  template <typename TagType> class TagStorage {
+    static_assert(std::is_empty_v<TagType>, "tag components carry no data");
+
+  public:
+    [[nodiscard]] bool contains(const Entity entity) const {
+      const uint32 index = entity_index(entity);
+      return is_set(index) && generations_[index] == entity_generation(entity);
+    }
+
+    void add(const Entity entity) {
+      const uint32 index = entity_index(entity);
+      if (is_set(index)) {
+        // the bit of an earlier generation is taken over, a stale handle leaves it alone
+        if (generations_[index] != entity_generation(entity)) {
+          if (!is_newer_generation(entity, make_entity(index, generations_[index]))) {
+            assert(false && "the tag is owned by a later generation of this entity");
+            return;
+          }
+          generations_[index] = static_cast<uint8>(entity_generation(entity));
+          log_change(entity);
+        }
+        return;
+      }
+      if (index / 64 >= bits_.size()) {
+        bits_.resize(index / 64 + 1, 0);
+        generations_.resize(bits_.size() * 64, 0);
+      }
+      bits_[index / 64] |= uint64{1} << (index % 64);
+      generations_[index] = static_cast<uint8>(entity_generation(entity));
+      ++count_;
+      log_change(entity);
+    }
+
+    void remove(const Entity entity) {
+      if (!contains(entity)) {
+        return;
+      }
+      const uint32 index = entity_index(entity);
+      bits_[index / 64] &= ~(uint64{1} << (index % 64));
+      --count_;
+      log_change(entity);
+    }
+
+    void set(const Entity entity, const bool tagged) {
+      if (tagged) {
+        add(entity);
+      } else {
+        remove(entity);
+      }
+    }
+
+    [[nodiscard]] uint64 version() const { return version_; }
+    [[nodiscard]] bool changed_since(const uint64 since) const { return version_ > since; }
+
+    /**
+     * \brief Calls fn(Entity) for every entity whose tag was added or removed after the given
+     * version, once per change, so an entity toggled twice is visited twice.
+     */
+    template <typename Fn> void for_each_changed_since(const uint64 since, Fn&& fn) const {
+      assert(since >= trimmed_version_ && "change log was trimmed past the requested version");
+      for (auto it = first_change_after(since); it != changes_.end(); ++it) {
+        fn(it->entity);
+      }
+    }
+
+    void advance_change_window() {
+      changes_.erase(changes_.begin(), first_change_after(window_start_));
+      trimmed_version_ = window_start_;
+      window_start_ = version_;
+    }
+
+    [[nodiscard]] size_t size() const { return count_; }
+    [[nodiscard]] bool empty() const { return count_ == 0; }
+
+    [[nodiscard]] StorageStats stats() const {
+      return {
+          .count = count_,
+          .bytes = bits_.capacity() * sizeof(uint64) + generations_.capacity() * sizeof(uint8)
+                   + changes_.capacity() * sizeof(Change),
+          .churn = version_ - window_start_,
+      };
+    }
+
+  private:
+    static_assert(kEntityGenerationMask <= 0xff, "generations are stored in a byte");
+
+    struct Change {
+      Entity entity;
+      uint64 version;
+    };
+
+    void log_change(const Entity entity) { changes_.push_back({entity, ++version_}); }
+
+    [[nodiscard]] auto first_change_after(const uint64 since) const {
+      return std::upper_bound(changes_.begin(), changes_.end(), since,
+                              [](const uint64 version, const Change& change) {
+                                return version < change.version;
+                              });
+    }
+
+    [[nodiscard]] bool is_set(const uint32 index) const {
+      return index / 64 < bits_.size() && (bits_[index / 64] >> (index % 64) & 1) != 0;
+    }
+
+    std::vector<uint64> bits_;
+    std::vector<uint8> generations_;  // generation that set the bit, per entity index
+    std::vector<Change> changes_;
+    size_t count_ = 0;
+    uint64 version_ = 0;
+    uint64 window_start_ = 0;
+    uint64 trimmed_version_ = 0;
+  };
+
+}  // namespace gestalt::foundation
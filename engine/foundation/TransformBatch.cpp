@@ -0,0 +1,222 @@
+﻿#include "TransformBatch.hpp"
+
+#include <cassert>
+#include <cmath>
+
+#include "TransformBatchKernels.hpp"
+
+#if defined(GESTALT_TRANSFORM_BATCH_X86)
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  endif
+#endif
+
+namespace gestalt::foundation {
+
+  namespace {
+    using detail::BlendLanes;
+    using detail::BoundsLanes;
+    using detail::TransformLanes;
+
+    struct ScalarLanes {
+      static constexpr size_t kWidth = 1;
+      static float32 load(const float32* source) { return *source; }
+      static void store(float32* target, const float32 value) { *target = value; }
+      static float32 set1(const float32 value) { return value; }
+      static float32 add(const float32 a, const float32 b) { return a + b; }
+      static float32 sub(const float32 a, const float32 b) { return a - b; }
+      static float32 mul(const float32 a, const float32 b) { return a * b; }
+      static float32 div(const float32 a, const float32 b) { return a / b; }
+      static float32 fmadd(const float32 a, const float32 b, const float32 c) { return a * b + c; }
+      static float32 sqrt(const float32 value) { return std::sqrt(value); }
+      static float32 abs(const float32 value) { return std::fabs(value); }
+    };
+
+#if defined(GESTALT_TRANSFORM_BATCH_X86)
+    // SSE2 is part of x86-64, so this path needs no detection
+    struct SseLanes {
+      static constexpr size_t kWidth = 4;
+      static __m128 load(const float32* source) { return _mm_loadu_ps(source); }
+      static void store(float32* target, const __m128 value) { _mm_storeu_ps(target, value); }
+      static __m128 set1(const float32 value) { return _mm_set1_ps(value); }
+      static __m128 add(const __m128 a, const __m128 b) { return _mm_add_ps(a, b); }
+      static __m128 sub(const __m128 a, const __m128 b) { return _mm_sub_ps(a, b); }
+      static __m128 mul(const __m128 a, const __m128 b) { return _mm_mul_ps(a, b); }
+      static __m128 div(const __m128 a, const __m128 b) { return _mm_div_ps(a, b); }
+      static __m128 fmadd(const __m128 a, const __m128 b, const __m128 c) {
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+      }
+      static __m128 sqrt(const __m128 value) { return _mm_sqrt_ps(value); }
+      static __m128 abs(const __m128 value) { return _mm_andnot_ps(_mm_set1_ps(-0.f), value); }
+    };
+#endif
+
+    SimdLevel detect_simd_level() {
+#if defined(GESTALT_TRANSFORM_BATCH_X86)
+#  if defined(_MSC_VER)
+      int info[4];
+      __cpuid(info, 0);
+      if (info[0] < 7) {
+        return SimdLevel::kSse;
+      }
+      __cpuid(info, 1);
+      const bool fma = (info[2] & (1 << 12)) != 0;
+      const bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+      __cpuidex(info, 7, 0);
+      const bool avx2 = (info[1] & (1 << 5)) != 0;
+      return fma && avx2 && os_saves_ymm ? SimdLevel::kAvx2 : SimdLevel::kSse;
+#  else
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? SimdLevel::kAvx2
+                                                                             : SimdLevel::kSse;
+#  endif
+#else
+      return SimdLevel::kScalar;
+#endif
+    }
+
+    TransformLanes<const float32> lanes(const TransformBatch& batch, const size_t offset = 0) {
+      return {batch.position_x.data() + offset, batch.position_y.data() + offset,
+              batch.position_z.data() + offset, batch.rotation_x.data() + offset,
+              batch.rotation_y.data() + offset, batch.rotation_z.data() + offset,
+              batch.rotation_w.data() + offset, batch.scale.data() + offset};
+    }
+
+    TransformLanes<float32> lanes(TransformBatch& batch, const size_t offset = 0) {
+      return {batch.position_x.data() + offset, batch.position_y.data() + offset,
+              batch.position_z.data() + offset, batch.rotation_x.data() + offset,
+              batch.rotation_y.data() + offset, batch.rotation_z.data() + offset,
+              batch.rotation_w.data() + offset, batch.scale.data() + offset};
+    }
+
+    BoundsLanes<const float32> lanes(const BoundsBatch& batch, const size_t offset = 0) {
+      return {batch.center_x.data() + offset, batch.center_y.data() + offset,
+              batch.center_z.data() + offset, batch.extent_x.data() + offset,
+              batch.extent_y.data() + offset, batch.extent_z.data() + offset};
+    }
+
+    BlendLanes<const float32> lanes(const BlendWeights& weights, const size_t offset = 0) {
+      return {weights.position.data() + offset, weights.rotation.data() + offset,
+              weights.scale.data() + offset};
+    }
+
+    BoundsLanes<float32> lanes(BoundsBatch& batch, const size_t offset = 0) {
+      return {batch.center_x.data() + offset, batch.center_y.data() + offset,
+              batch.center_z.data() + offset, batch.extent_x.data() + offset,
+              batch.extent_y.data() + offset, batch.extent_z.data() + offset};
+    }
+  }  // namespace
+
+  void TransformBatch::resize(const size_t count) {
+    position_x.resize(count);
+    position_y.resize(count);
+    position_z.resize(count);
+    rotation_x.resize(count);
+    rotation_y.resize(count);
+    rotation_z.resize(count);
+    rotation_w.resize(count);
+    scale.resize(count);
+  }
+
+  void BoundsBatch::resize(const size_t count) {
+    center_x.resize(count);
+    center_y.resize(count);
+    center_z.resize(count);
+    extent_x.resize(count);
+    extent_y.resize(count);
+    extent_z.resize(count);
+  }
+
+  void BlendWeights::resize(const size_t count) {
+    position.resize(count);
+    rotation.resize(count);
+    scale.resize(count);
+  }
+
+  SimdLevel transform_batch_simd_level() {
+    static const SimdLevel level = detect_simd_level();
+    return level;
+  }
+
+  void compose_transforms(const TransformBatch& parents, const TransformBatch& locals,
+                          TransformBatch& worlds) {
+    assert(parents.size() == locals.size() && "every local transform needs a parent transform");
+    const size_t count = locals.size();
+    worlds.resize(count);
+
+    // the vector kernels take the multiple of their width, the scalar one the remainder
+    size_t done = 0;
+    switch (transform_batch_simd_level()) {
+#if defined(GESTALT_TRANSFORM_BATCH_X86)
+      case SimdLevel::kAvx2:
+        done = count & ~size_t{7};
+        detail::compose_transforms_avx2(lanes(parents), lanes(locals), lanes(worlds), done);
+        break;
+      case SimdLevel::kSse:
+        done = count & ~size_t{3};
+        detail::compose_transforms<SseLanes>(lanes(parents), lanes(locals), lanes(worlds), done);
+        break;
+#endif
+      default:
+        break;
+    }
+    detail::compose_transforms<ScalarLanes>(lanes(parents, done), lanes(locals, done),
+                                            lanes(worlds, done), count - done);
+  }
+
+  void transform_bounds(const TransformBatch& worlds, const BoundsBatch& locals,
+                        BoundsBatch& results) {
+    assert(worlds.size() == locals.size() && "every box needs a transform");
+    const size_t count = locals.size();
+    results.resize(count);
+
+    size_t done = 0;
+    switch (transform_batch_simd_level()) {
+#if defined(GESTALT_TRANSFORM_BATCH_X86)
+      case SimdLevel::kAvx2:
+        done = count & ~size_t{7};
+        detail::transform_bounds_avx2(lanes(worlds), lanes(locals), lanes(results), done);
+        break;
+      case SimdLevel::kSse:
+        done = count & ~size_t{3};
+        detail::transform_bounds<SseLanes>(lanes(worlds), lanes(locals), lanes(results), done);
+        break;
+#endif
+      default:
+        break;
+    }
+    detail::transform_bounds<ScalarLanes>(lanes(worlds, done), lanes(locals, done),
+                                          lanes(results, done), count - done);
+  }
+
+  void blend_transforms(const TransformBatch& from, const TransformBatch& to,
+                        const BlendWeights& weights, TransformBatch& results) {
+    assert(from.size() == to.size() && from.size() == weights.size()
+           && "every transform needs a target and weights");
+    const size_t count = from.size();
+    results.resize(count);
+
+    size_t done = 0;
+    switch (transform_batch_simd_level()) {
+#if defined(GESTALT_TRANSFORM_BATCH_X86)
+      case SimdLevel::kAvx2:
+        done = count & ~size_t{7};
+        detail::blend_transforms_avx2(lanes(from), lanes(to), lanes(weights), lanes(results),
+                                      done);
+        break;
+      case SimdLevel::kSse:
+        done = count & ~size_t{3};
+        detail::blend_transforms<SseLanes>(lanes(from), lanes(to), lanes(weights),
+                                           lanes(results), done);
+        break;
+#endif
+      default:
+        break;
+    }
+    detail::blend_transforms<ScalarLanes>(lanes(from, done), lanes(to, done),
+                                          lanes(weights, done), lanes(results, done),
+                                          count - done);
+  }
+
+}  // namespace gestalt::foundation
@@ -0,0 +1,114 @@
+﻿#pragma once
+
+#include <vector>
+
+#include "glm/vec3.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include "common.hpp"
+
+namespace gestalt::foundation {
+
+  /** \brief Positions, rotations and uniform scales of many nodes, one array per scalar. */
+  struct TransformBatch {
+    std::vector<float32> position_x;
+    std::vector<float32> position_y;
+    std::vector<float32> position_z;
+    std::vector<float32> rotation_x;
+    std::vector<float32> rotation_y;
+    std::vector<float32> rotation_z;
+    std::vector<float32> rotation_w;
+    std::vector<float32> scale;
+
+    void resize(size_t count);
+    [[nodiscard]] size_t size() const { return scale.size(); }
+
+    void set(const size_t i, const glm::vec3& position, const glm::quat& rotation,
+             const float32 uniform_scale) {
+      position_x[i] = position.x;
+      position_y[i] = position.y;
+      position_z[i] = position.z;
+      rotation_x[i] = rotation.x;
+      rotation_y[i] = rotation.y;
+      rotation_z[i] = rotation.z;
+      rotation_w[i] = rotation.w;
+      scale[i] = uniform_scale;
+    }
+
+    [[nodiscard]] glm::vec3 position(const size_t i) const {
+      return {position_x[i], position_y[i], position_z[i]};
+    }
+
+    [[nodiscard]] glm::quat rotation(const size_t i) const {
+      return {rotation_w[i], rotation_x[i], rotation_y[i], rotation_z[i]};
+    }
+  };
+
+  /** \brief Axis aligned boxes of many nodes as center and half extent, one array per scalar. */
+  struct BoundsBatch {
+    std::vector<float32> center_x;
+    std::vector<float32> center_y;
+    std::vector<float32> center_z;
+    std::vector<float32> extent_x;
+    std::vector<float32> extent_y;
+    std::vector<float32> extent_z;
+
+    void resize(size_t count);
+    [[nodiscard]] size_t size() const { return center_x.size(); }
+
+    void set(const size_t i, const glm::vec3& center, const glm::vec3& extent) {
+      center_x[i] = center.x;
+      center_y[i] = center.y;
+      center_z[i] = center.z;
+      extent_x[i] = extent.x;
+      extent_y[i] = extent.y;
+      extent_z[i] = extent.z;
+    }
+
+    [[nodiscard]] glm::vec3 center(const size_t i) const {
+      return {center_x[i], center_y[i], center_z[i]};
+    }
+
+    [[nodiscard]] glm::vec3 extent(const size_t i) const {
+      return {extent_x[i], extent_y[i], extent_z[i]};
+    }
+  };
+
+  /** \brief Blend weights of many transforms, one array per component. */
+  struct BlendWeights {
+    std::vector<float32> position;
+    std::vector<float32> rotation;
+    std::vector<float32> scale;
+
+    void resize(size_t count);
+    [[nodiscard]] size_t size() const { return position.size(); }
+  };
+
+  enum class SimdLevel : uint8 { kScalar, kSse, kAvx2 };
+
+  /** \brief Widest instruction set the batch kernels use on this CPU, detected once. */
+  [[nodiscard]] SimdLevel transform_batch_simd_level();
+
+  /**
+   * \brief Composes worlds[i] = parents[i] * locals[i]: the local position is scaled, rotated and
+   * offset by the parent, rotations are multiplied and scales too. worlds is resized to match.
+   */
+  void compose_transforms(const TransformBatch& parents, const TransformBatch& locals,
+                          TransformBatch& worlds);
+
+  /**
+   * \brief Transforms local boxes into world space with the transform of the same index.
+   * results is resized to match.
+   */
+  void transform_bounds(const TransformBatch& worlds, const BoundsBatch& locals,
+                        BoundsBatch& results);
+
+  /**
+   * \brief Blends from[i] towards to[i] with the weights of the same index. Positions and scales
+   * are lerped, rotations are normalized lerps, so from and to must lie in the same hemisphere.
+   * results is resized to match.
+   */
+  void blend_transforms(const TransformBatch& from, const TransformBatch& to,
+                        const BlendWeights& weights, TransformBatch& results);
+
+}  // namespace gestalt::foundation
@@ -0,0 +1,51 @@
+﻿// Compiled with AVX2 and FMA enabled (see CMakeLists.txt) and only entered after the CPU was
+// checked, so nothing here may be shared with code that runs without that check.
+
+#include "TransformBatchKernels.hpp"
+
+#if defined(GESTALT_TRANSFORM_BATCH_X86)
+#  include <immintrin.h>
+
+namespace gestalt::foundation::detail {
+
+  namespace {
+    struct Avx2Lanes {
+      static constexpr size_t kWidth = 8;
+      static __m256 load(const float32* source) { return _mm256_loadu_ps(source); }
+      static void store(float32* target, const __m256 value) { _mm256_storeu_ps(target, value); }
+      static __m256 set1(const float32 value) { return _mm256_set1_ps(value); }
+      static __m256 add(const __m256 a, const __m256 b) { return _mm256_add_ps(a, b); }
+      static __m256 sub(const __m256 a, const __m256 b) { return _mm256_sub_ps(a, b); }
+      static __m256 mul(const __m256 a, const __m256 b) { return _mm256_mul_ps(a, b); }
+      static __m256 div(const __m256 a, const __m256 b) { return _mm256_div_ps(a, b); }
+      static __m256 fmadd(const __m256 a, const __m256 b, const __m256 c) {
+        return _mm256_fmadd_ps(a, b, c);
+      }
+      static __m256 sqrt(const __m256 value) { return _mm256_sqrt_ps(value); }
+      static __m256 abs(const __m256 value) {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.f), value);
+      }
+    };
+  }  // namespace
+
+  void compose_transforms_avx2(const TransformLanes<const float32>& parents,
+                               const TransformLanes<const float32>& locals,
+                               const TransformLanes<float32>& worlds, const size_t count) {
+    compose_transforms<Avx2Lanes>(parents, locals, worlds, count);
+  }
+
+  void transform_bounds_avx2(const TransformLanes<const float32>& worlds,
+                             const BoundsLanes<const float32>& locals,
+                             const BoundsLanes<float32>& results, const size_t count) {
+    transform_bounds<Avx2Lanes>(worlds, locals, results, count);
+  }
+
+  void blend_transforms_avx2(const TransformLanes<const float32>& from,
+                             const TransformLanes<const float32>& to,
+                             const BlendLanes<const float32>& weights,
+                             const TransformLanes<float32>& results, const size_t count) {
+    blend_transforms<Avx2Lanes>(from, to, weights, results, count);
+  }
+
+}  // namespace gestalt::foundation::detail
+#endif
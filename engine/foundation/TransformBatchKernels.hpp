@@ -0,0 +1,230 @@
+﻿#pragma once
+
+#include <cstddef>
+
+#include "common.hpp"
+
+// Included by the translation units that implement the batch kernels for one instruction set.
+// It must stay free of inline functions with external linkage, those could be compiled with a
+// wider instruction set than the CPU supports and then be picked by the linker for every caller.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define GESTALT_TRANSFORM_BATCH_X86 1
+#endif
+
+namespace gestalt::foundation::detail {
+
+  template <typename Float> struct TransformLanes {
+    Float* position_x;
+    Float* position_y;
+    Float* position_z;
+    Float* rotation_x;
+    Float* rotation_y;
+    Float* rotation_z;
+    Float* rotation_w;
+    Float* scale;
+  };
+
+  template <typename Float> struct BoundsLanes {
+    Float* center_x;
+    Float* center_y;
+    Float* center_z;
+    Float* extent_x;
+    Float* extent_y;
+    Float* extent_z;
+  };
+
+  template <typename Float> struct BlendLanes {
+    Float* position;
+    Float* rotation;
+    Float* scale;
+  };
+
+  /**
+   * \brief world = parent * local for count nodes, count must be a multiple of Lanes::kWidth.
+   * Lanes provides the vector type and load, store, set1, add, sub, mul, div, fmadd (a * b + c),
+   * sqrt and abs on it.
+   */
+  template <typename Lanes>
+  void compose_transforms(const TransformLanes<const float32>& parents,
+                          const TransformLanes<const float32>& locals,
+                          const TransformLanes<float32>& worlds, const size_t count) {
+    const auto two = Lanes::set1(2.f);
+
+    for (size_t i = 0; i < count; i += Lanes::kWidth) {
+      const auto px = Lanes::load(parents.position_x + i);
+      const auto py = Lanes::load(parents.position_y + i);
+      const auto pz = Lanes::load(parents.position_z + i);
+      const auto qx = Lanes::load(parents.rotation_x + i);
+      const auto qy = Lanes::load(parents.rotation_y + i);
+      const auto qz = Lanes::load(parents.rotation_z + i);
+      const auto qw = Lanes::load(parents.rotation_w + i);
+      const auto ps = Lanes::load(parents.scale + i);
+
+      const auto lx = Lanes::load(locals.rotation_x + i);
+      const auto ly = Lanes::load(locals.rotation_y + i);
+      const auto lz = Lanes::load(locals.rotation_z + i);
+      const auto lw = Lanes::load(locals.rotation_w + i);
+
+      // rotation = parent rotation * local rotation
+      Lanes::store(worlds.rotation_w + i,
+                   Lanes::sub(Lanes::mul(qw, lw),
+                              Lanes::fmadd(qx, lx, Lanes::fmadd(qy, ly, Lanes::mul(qz, lz)))));
+      Lanes::store(worlds.rotation_x + i,
+                   Lanes::sub(Lanes::fmadd(qw, lx, Lanes::fmadd(qx, lw, Lanes::mul(qy, lz))),
+                              Lanes::mul(qz, ly)));
+      Lanes::store(worlds.rotation_y + i,
+                   Lanes::sub(Lanes::fmadd(qw, ly, Lanes::fmadd(qy, lw, Lanes::mul(qz, lx))),
+                              Lanes::mul(qx, lz)));
+      Lanes::store(worlds.rotation_z + i,
+                   Lanes::sub(Lanes::fmadd(qw, lz, Lanes::fmadd(qz, lw, Lanes::mul(qx, ly))),
+                              Lanes::mul(qy, lx)));
+
+      // position = parent position + parent rotation * (parent scale * local position),
+      // rotating v by q as v + w * t + cross(q.xyz, t) with t = 2 * cross(q.xyz, v)
+      const auto vx = Lanes::mul(ps, Lanes::load(locals.position_x + i));
+      const auto vy = Lanes::mul(ps, Lanes::load(locals.position_y + i));
+      const auto vz = Lanes::mul(ps, Lanes::load(locals.position_z + i));
+
+      const auto tx = Lanes::mul(two, Lanes::sub(Lanes::mul(qy, vz), Lanes::mul(qz, vy)));
+      const auto ty = Lanes::mul(two, Lanes::sub(Lanes::mul(qz, vx), Lanes::mul(qx, vz)));
+      const auto tz = Lanes::mul(two, Lanes::sub(Lanes::mul(qx, vy), Lanes::mul(qy, vx)));
+
+      Lanes::store(worlds.position_x + i,
+                   Lanes::add(Lanes::add(px, Lanes::fmadd(qw, tx, vx)),
+                              Lanes::sub(Lanes::mul(qy, tz), Lanes::mul(qz, ty))));
+      Lanes::store(worlds.position_y + i,
+                   Lanes::add(Lanes::add(py, Lanes::fmadd(qw, ty, vy)),
+                              Lanes::sub(Lanes::mul(qz, tx), Lanes::mul(qx, tz))));
+      Lanes::store(worlds.position_z + i,
+                   Lanes::add(Lanes::add(pz, Lanes::fmadd(qw, tz, vz)),
+                              Lanes::sub(Lanes::mul(qx, ty), Lanes::mul(qy, tx))));
+
+      Lanes::store(worlds.scale + i, Lanes::mul(ps, Lanes::load(locals.scale + i)));
+    }
+  }
+
+  /**
+   * \brief Transforms count local boxes given as center and half extent into world space, count
+   * must be a multiple of Lanes::kWidth. The center is transformed as a point, the extent by the
+   * absolute rotation matrix, which gives the same box as Arvo's method.
+   */
+  template <typename Lanes>
+  void transform_bounds(const TransformLanes<const float32>& worlds,
+                        const BoundsLanes<const float32>& locals,
+                        const BoundsLanes<float32>& results, const size_t count) {
+    const auto one = Lanes::set1(1.f);
+    const auto two = Lanes::set1(2.f);
+
+    for (size_t i = 0; i < count; i += Lanes::kWidth) {
+      const auto qx = Lanes::load(worlds.rotation_x + i);
+      const auto qy = Lanes::load(worlds.rotation_y + i);
+      const auto qz = Lanes::load(worlds.rotation_z + i);
+      const auto qw = Lanes::load(worlds.rotation_w + i);
+      const auto s = Lanes::load(worlds.scale + i);
+
+      const auto xx = Lanes::mul(qx, qx);
+      const auto yy = Lanes::mul(qy, qy);
+      const auto zz = Lanes::mul(qz, qz);
+      const auto xy = Lanes::mul(qx, qy);
+      const auto xz = Lanes::mul(qx, qz);
+      const auto yz = Lanes::mul(qy, qz);
+      const auto wx = Lanes::mul(qw, qx);
+      const auto wy = Lanes::mul(qw, qy);
+      const auto wz = Lanes::mul(qw, qz);
+
+      // rows of scale * rotation matrix
+      const auto m00 = Lanes::mul(s, Lanes::sub(one, Lanes::mul(two, Lanes::add(yy, zz))));
+      const auto m01 = Lanes::mul(s, Lanes::mul(two, Lanes::sub(xy, wz)));
+      const auto m02 = Lanes::mul(s, Lanes::mul(two, Lanes::add(xz, wy)));
+      const auto m10 = Lanes::mul(s, Lanes::mul(two, Lanes::add(xy, wz)));
+      const auto m11 = Lanes::mul(s, Lanes::sub(one, Lanes::mul(two, Lanes::add(xx, zz))));
+      const auto m12 = Lanes::mul(s, Lanes::mul(two, Lanes::sub(yz, wx)));
+      const auto m20 = Lanes::mul(s, Lanes::mul(two, Lanes::sub(xz, wy)));
+      const auto m21 = Lanes::mul(s, Lanes::mul(two, Lanes::add(yz, wx)));
+      const auto m22 = Lanes::mul(s, Lanes::sub(one, Lanes::mul(two, Lanes::add(xx, yy))));
+
+      const auto cx = Lanes::load(locals.center_x + i);
+      const auto cy = Lanes::load(locals.center_y + i);
+      const auto cz = Lanes::load(locals.center_z + i);
+      const auto ex = Lanes::load(locals.extent_x + i);
+      const auto ey = Lanes::load(locals.extent_y + i);
+      const auto ez = Lanes::load(locals.extent_z + i);
+
+      Lanes::store(results.center_x + i,
+                   Lanes::fmadd(m00, cx, Lanes::fmadd(m01, cy, Lanes::fmadd(m02, cz,
+                                Lanes::load(worlds.position_x + i)))));
+      Lanes::store(results.center_y + i,
+                   Lanes::fmadd(m10, cx, Lanes::fmadd(m11, cy, Lanes::fmadd(m12, cz,
+                                Lanes::load(worlds.position_y + i)))));
+      Lanes::store(results.center_z + i,
+                   Lanes::fmadd(m20, cx, Lanes::fmadd(m21, cy, Lanes::fmadd(m22, cz,
+                                Lanes::load(worlds.position_z + i)))));
+
+      Lanes::store(results.extent_x + i,
+                   Lanes::fmadd(Lanes::abs(m00), ex,
+                                Lanes::fmadd(Lanes::abs(m01), ey, Lanes::mul(Lanes::abs(m02), ez))));
+      Lanes::store(results.extent_y + i,
+                   Lanes::fmadd(Lanes::abs(m10), ex,
+                                Lanes::fmadd(Lanes::abs(m11), ey, Lanes::mul(Lanes::abs(m12), ez))));
+      Lanes::store(results.extent_z + i,
+                   Lanes::fmadd(Lanes::abs(m20), ex,
+                                Lanes::fmadd(Lanes::abs(m21), ey, Lanes::mul(Lanes::abs(m22), ez))));
+    }
+  }
+
+  /**
+   * \brief Lerps positions and scales and nlerps rotations of count transforms, count must be a
+   * multiple of Lanes::kWidth.
+   */
+  template <typename Lanes>
+  void blend_transforms(const TransformLanes<const float32>& from,
+                        const TransformLanes<const float32>& to,
+                        const BlendLanes<const float32>& weights,
+                        const TransformLanes<float32>& results, const size_t count) {
+    const auto one = Lanes::set1(1.f);
+
+    const auto lerp = [](const float32* a, const float32* b, const auto weight) {
+      const auto start = Lanes::load(a);
+      return Lanes::fmadd(weight, Lanes::sub(Lanes::load(b), start), start);
+    };
+
+    for (size_t i = 0; i < count; i += Lanes::kWidth) {
+      const auto wp = Lanes::load(weights.position + i);
+      Lanes::store(results.position_x + i, lerp(from.position_x + i, to.position_x + i, wp));
+      Lanes::store(results.position_y + i, lerp(from.position_y + i, to.position_y + i, wp));
+      Lanes::store(results.position_z + i, lerp(from.position_z + i, to.position_z + i, wp));
+
+      const auto wr = Lanes::load(weights.rotation + i);
+      const auto qx = lerp(from.rotation_x + i, to.rotation_x + i, wr);
+      const auto qy = lerp(from.rotation_y + i, to.rotation_y + i, wr);
+      const auto qz = lerp(from.rotation_z + i, to.rotation_z + i, wr);
+      const auto qw = lerp(from.rotation_w + i, to.rotation_w + i, wr);
+      const auto inverse_length = Lanes::div(
+          one, Lanes::sqrt(Lanes::fmadd(qx, qx, Lanes::fmadd(qy, qy, Lanes::fmadd(qz, qz,
+                                                                   Lanes::mul(qw, qw))))));
+      Lanes::store(results.rotation_x + i, Lanes::mul(qx, inverse_length));
+      Lanes::store(results.rotation_y + i, Lanes::mul(qy, inverse_length));
+      Lanes::store(results.rotation_z + i, Lanes::mul(qz, inverse_length));
+      Lanes::store(results.rotation_w + i, Lanes::mul(qw, inverse_length));
+
+      Lanes::store(results.scale + i,
+                   lerp(from.scale + i, to.scale + i, Lanes::load(weights.scale + i)));
+    }
+  }
+
+#if defined(GESTALT_TRANSFORM_BATCH_X86)
+  // TransformBatchAvx2.cpp, only called if the CPU supports AVX2 and FMA
+  void compose_transforms_avx2(const TransformLanes<const float32>& parents,
+                               const TransformLanes<const float32>& locals,
+                               const TransformLanes<float32>& worlds, size_t count);
+  void transform_bounds_avx2(const TransformLanes<const float32>& worlds,
+                             const BoundsLanes<const float32>& locals,
+                             const BoundsLanes<float32>& results, size_t count);
+  void blend_transforms_avx2(const TransformLanes<const float32>& from,
+                             const TransformLanes<const float32>& to,
+                             const BlendLanes<const float32>& weights,
+                             const TransformLanes<float32>& results, size_t count);
+#endif
+
+}  // namespace gestalt::foundation::detail
@@ -0,0 +1,25 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace gestalt::foundation {
+
+  /** \brief Unqualified name of the type, e.g. "NodeComponent". */
+  template <typename T> [[nodiscard]] constexpr std::string_view type_name() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    std::string_view name = __FUNCSIG__;
+    name.remove_prefix(name.find("type_name<") + 10);
+    name = name.substr(0, name.rfind(">(void)"));
+#else
+    std::string_view name = __PRETTY_FUNCTION__;
+    name.remove_prefix(name.find("T = ") + 4);
+    name = name.substr(0, name.find_first_of(";]"));
+#endif
+    if (const size_t scope = name.rfind("::"); scope != std::string_view::npos) {
+      name.remove_prefix(scope + 2);
+    }
+    return name;
+  }
+
+}  // namespace gestalt::foundation
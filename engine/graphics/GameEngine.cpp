@@ -12,7 +12,7 @@ namespace gestalt {
       : gpu_(window_),
         frame_provider_(&frame_number_),
         resource_allocator_(gpu_),
-        ecs_(gpu_, resource_allocator_, repository_, event_bus_, frame_provider_),
+        ecs_(gpu_, resource_allocator_, repository_, event_bus_, frame_provider_, job_system_),
         render_engine_(gpu_, window_, resource_allocator_, repository_, imgui_.get(), frame_provider_)
   {
     imgui_ = std::make_unique<application::Gui>(
@@ -23,7 +23,8 @@ namespace gestalt {
             [&]() -> application::ComponentFactory& { return ecs_.get_component_factory(); },
             [&]() -> graphics::RenderConfig& { return render_engine_.get_config(); },
             [&](foundation::Entity camera) { ecs_.set_active_camera(camera); },
-            [&]() -> foundation::Entity { return ecs_.get_active_camera(); }}
+            [&]() -> foundation::Entity { return ecs_.get_active_camera(); },
+            [&](foundation::Entity entity) { ecs_.destroy_entity(entity); }}
         );
 
     is_initialized_ = true;
@@ -7,6 +7,7 @@
 #include "Render Engine/RenderEngine.hpp"
 #include "ECS/EntityComponentSystem.hpp"
 #include "FrameProvider.hpp"
+#include "JobSystem.hpp"
 #include "ResourceAllocator.hpp"
 #include "TmeTrackingService.hpp"
 #include "Events/EventBus.hpp"
@@ -31,6 +32,7 @@ namespace gestalt {
     bool freeze_rendering_{false};
     uint64 frame_number_{0};
 
+    foundation::JobSystem job_system_;
     application::EventBus event_bus_;
     application::Window window_;
     graphics::Gpu gpu_;
@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <string_view>
+
+#include <fmt/core.h>
+
+#include "common.hpp"
+
+namespace gestalt::tests {
+
+  /** \brief Runs fn repeats times and returns the fastest run in milliseconds. */
+  template <typename Fn> float64 measure_ms(Fn&& fn, const uint32 repeats = 5) {
+    float64 best = 0.0;
+    for (uint32 i = 0; i < repeats; ++i) {
+      const auto start = std::chrono::steady_clock::now();
+      fn();
+      const std::chrono::duration<float64, std::milli> elapsed
+          = std::chrono::steady_clock::now() - start;
+      best = i == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+  }
+
+  /** \brief Prints one result line, the time per item in nanoseconds next to the total. */
+  inline void report(const std::string_view name, const float64 ms, const uint64 items) {
+    fmt::println("{:<48} {:>10.3f} ms {:>9.2f} ns/item", name, ms,
+                 items > 0 ? ms * 1e6 / static_cast<float64>(items) : 0.0);
+  }
+
+  /**
+   * \brief Keeps a result alive, so the optimizer cannot drop the work that produced it. Print the
+   * returned sum at the end of a benchmark.
+   */
+  inline uint64& checksum() {
+    static uint64 sum = 0;
+    return sum;
+  }
+
+}  // namespace gestalt::tests
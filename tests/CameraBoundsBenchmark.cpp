@@ -0,0 +1,122 @@
+﻿#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Repository.hpp"
+#include "ECS/ComponentFactory.hpp"
+#include "ECS/SystemContext.hpp"
+#include "ECS/TransformSystem.hpp"
+#include "Events/EventBus.hpp"
+
+// A static scene of 100k mesh nodes and a camera circling it, one TransformSystem::update per
+// frame. The camera is a child of the root like the editor camera, once contributing to the bounds
+// of its ancestors as every node did before and once excluded as cameras and lights are now. The
+// meshes sit directly below the root, as the top-level nodes of a flat glTF import do, or in 100
+// groups of 1000. The scene bounds must not contain the excluded camera.
+
+using namespace gestalt::foundation;
+using namespace gestalt::application;
+using namespace gestalt::tests;
+
+namespace {
+
+  constexpr uint32 kNodes = 100'000;
+  constexpr uint32 kRowLength = 100;
+  constexpr float32 kSpacing = 4.f;
+  constexpr uint32 kFrames = 600;
+
+  struct Result {
+    float64 frame_ms = 0.0;
+    AABB scene_bounds;
+  };
+
+  /** group_size 0 puts every mesh node directly below the root. */
+  Result run(const uint32 group_size, const bool camera_contributes) {
+    const auto repository = std::make_unique<Repository>();
+    EventBus event_bus;
+    ComponentFactory factory(*repository, event_bus);
+    TransformSystem transform_system(*repository, event_bus);
+    const SystemContext context(*repository, "TransformSystem", SystemAccess{}, false);
+    const auto update = [&] {
+      event_bus.poll();
+      transform_system.update(context);
+      repository->advance_change_windows();
+    };
+
+    repository->meshes.add(Mesh{"box", {}, BoundingSphere{glm::vec3(0.f), 1.f},
+                                AABB{glm::vec3(-1.f), glm::vec3(1.f)}});
+    Entity group = root_entity;
+    for (uint32 i = 0; i < kNodes; ++i) {
+      if (group_size > 0 && i % group_size == 0) {
+        group = factory.create_entity().first;
+        factory.link_entity_to_parent(group, root_entity);
+        factory.set_static(group, true);
+      }
+      const glm::vec3 position(static_cast<float32>(i % kRowLength) * kSpacing, 0.f,
+                               static_cast<float32>(i / kRowLength) * kSpacing);
+      const Entity entity = factory.create_entity({}, position).first;
+      factory.add_mesh_component(entity, 0);
+      factory.link_entity_to_parent(entity, group);
+      factory.set_static(entity, true);
+    }
+
+    const Entity camera = factory.create_entity("camera").first;
+    factory.link_entity_to_parent(camera, root_entity);
+    if (!camera_contributes) {
+      factory.add_free_fly_camera(glm::vec3(0.f), glm::vec3(0.f, 0.f, -1.f),
+                                  glm::vec3(0.f, 1.f, 0.f), camera);
+    }
+    update();
+
+    // outside the scene, so a contributing camera changes the scene bounds every frame
+    const glm::vec3 center(kRowLength * kSpacing * 0.5f, 0.f, kNodes / kRowLength * kSpacing * 0.5f);
+    const float32 radius = kNodes / kRowLength * kSpacing;
+    Result result;
+    result.frame_ms = measure_ms(
+                          [&] {
+                            for (uint32 frame = 0; frame < kFrames; ++frame) {
+                              const float32 angle = static_cast<float32>(frame) * 0.01f;
+                              repository->transform_components.find_mutable(camera)->set_position(
+                                  center
+                                  + glm::vec3(std::cos(angle), 0.5f, std::sin(angle)) * radius);
+                              repository->transform_components.mark_changed(camera);
+                              update();
+                            }
+                          },
+                          1)
+                      / kFrames;
+    result.scene_bounds = repository->scene_graph.find(root_entity)->bounds;
+    return result;
+  }
+
+}  // namespace
+
+int main() {
+  const Result flat_before = run(0, true);
+  const Result flat_after = run(0, false);
+  const Result grouped_before = run(1000, true);
+  const Result grouped_after = run(1000, false);
+
+  fmt::println("{} static mesh nodes, a camera below the root, {} frames", kNodes, kFrames);
+  report("flat, camera in the bounds", flat_before.frame_ms, 1);
+  report("flat, camera excluded", flat_after.frame_ms, 1);
+  report("100 groups, camera in the bounds", grouped_before.frame_ms, 1);
+  report("100 groups, camera excluded", grouped_after.frame_ms, 1);
+
+  // the boxes of the mesh nodes only, their bounding spheres have radius 1
+  const glm::vec3 expected_min(-1.f);
+  const glm::vec3 expected_max((kRowLength - 1) * kSpacing + 1.f, 1.f,
+                               (kNodes / kRowLength - 1) * kSpacing + 1.f);
+  bool failed = false;
+  for (const Result* result : {&flat_after, &grouped_after}) {
+    if (glm::any(glm::greaterThan(glm::abs(result->scene_bounds.min - expected_min),
+                                  glm::vec3(1e-3f)))
+        || glm::any(glm::greaterThan(glm::abs(result->scene_bounds.max - expected_max),
+                                     glm::vec3(1e-3f)))) {
+      fmt::println("the scene bounds contain the excluded camera");
+      failed = true;
+    }
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+﻿#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "ComponentStorage.hpp"
+
+// Sparse set storage against the hash map it replaced: insert, lookup in random order, a full
+// scan and removal of half the entities, for a component about the size of a transform.
+
+using namespace gestalt::foundation;
+using namespace gestalt::tests;
+
+namespace {
+
+  struct Payload {
+    float32 values[15] = {};
+    uint32 tag = 0;
+  };
+
+  struct HashIndexed : Payload {
+    using storage_index = HashIndex;
+  };
+
+  // the storage before the sparse set, an unordered_map keyed by the entity
+  template <typename ComponentType> class MapStorage {
+  public:
+    void upsert(const Entity entity, const ComponentType& component) {
+      components_.insert_or_assign(entity, component);
+    }
+    [[nodiscard]] const ComponentType* find(const Entity entity) const {
+      const auto it = components_.find(entity);
+      return it != components_.end() ? &it->second : nullptr;
+    }
+    void remove(const Entity entity) { components_.erase(entity); }
+    template <typename Fn> void for_each(Fn&& fn) const {
+      for (const auto& [entity, component] : components_) {
+        fn(entity, component);
+      }
+    }
+
+  private:
+    std::unordered_map<Entity, ComponentType> components_;
+  };
+
+  template <typename Storage, typename ComponentType>
+  void run(const std::string& name, const std::vector<Entity>& entities,
+           const std::vector<Entity>& shuffled) {
+    const auto count = static_cast<uint64>(entities.size());
+
+    const auto fill = [&](Storage& storage) {
+      for (const Entity entity : entities) {
+        ComponentType component;
+        component.tag = entity;
+        storage.upsert(entity, component);
+      }
+    };
+
+    const float64 insert_ms = measure_ms([&] {
+      Storage storage;
+      fill(storage);
+      checksum() += storage.find(entities.back())->tag;
+    });
+
+    Storage storage;
+    fill(storage);
+
+    const float64 lookup_ms = measure_ms([&] {
+      uint64 sum = 0;
+      for (const Entity entity : shuffled) {
+        sum += storage.find(entity)->tag;
+      }
+      checksum() += sum;
+    });
+
+    const float64 scan_ms = measure_ms([&] {
+      uint64 sum = 0;
+      storage.for_each([&](Entity, const ComponentType& component) { sum += component.tag; });
+      checksum() += sum;
+    });
+
+    // storages are not copyable, so removal is timed together with a fill and the fill subtracted
+    const std::vector<Entity> removed(shuffled.begin(), shuffled.begin() + shuffled.size() / 2);
+    const float64 fill_and_remove_ms = measure_ms([&] {
+      Storage filled;
+      fill(filled);
+      for (const Entity entity : removed) {
+        filled.remove(entity);
+      }
+      checksum() += filled.find(shuffled.back()) != nullptr;
+    });
+    const float64 remove_ms = std::max(fill_and_remove_ms - insert_ms, 0.0);
+
+    report(name + " insert", insert_ms, count);
+    report(name + " lookup, random order", lookup_ms, count);
+    report(name + " full scan", scan_ms, count);
+    report(name + " remove half", remove_ms, removed.size());
+  }
+
+}  // namespace
+
+int main() {
+  for (const uint32 count : {10'000u, 100'000u, 1'000'000u}) {
+    std::vector<Entity> entities(count);
+    std::iota(entities.begin(), entities.end(), 1u);
+    std::vector<Entity> shuffled = entities;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(count));
+
+    fmt::println("{} entities", count);
+    run<MapStorage<Payload>, Payload>("  unordered_map", entities, shuffled);
+    run<ComponentStorage<Payload>, Payload>("  sparse set, paged index", entities, shuffled);
+    run<ComponentStorage<HashIndexed>, HashIndexed>("  sparse set, hash index", entities,
+                                                     shuffled);
+  }
+  fmt::println("checksum {}", checksum());
+  return 0;
+}
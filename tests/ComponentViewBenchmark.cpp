@@ -0,0 +1,106 @@
+﻿#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "ComponentView.hpp"
+
+// A join of two and three storages through ComponentView against the loop it replaced in the
+// systems: walk the smallest storage and look the other components up per entity. The storages
+// are filled in different orders, as they are after a while of creating and destroying entities.
+
+using namespace gestalt::foundation;
+using namespace gestalt::tests;
+
+namespace {
+
+  struct Transform {
+    float32 values[16] = {};
+  };
+
+  struct Mesh {
+    uint32 mesh = 0;
+    uint32 draws[7] = {};
+  };
+
+  struct Light {
+    float32 color[3] = {};
+    float32 intensity = 0.f;
+  };
+
+  void run(const uint32 count) {
+    std::vector<Entity> entities(count);
+    std::iota(entities.begin(), entities.end(), 1u);
+    std::mt19937 random(count);
+
+    ComponentStorage<Transform> transforms;
+    ComponentStorage<Mesh> meshes;
+    ComponentStorage<Light> lights;
+    std::shuffle(entities.begin(), entities.end(), random);
+    for (const Entity entity : entities) {
+      transforms.upsert(entity, Transform{{static_cast<float32>(entity)}});
+    }
+    std::shuffle(entities.begin(), entities.end(), random);
+    for (const Entity entity : entities) {
+      meshes.upsert(entity, Mesh{entity});
+    }
+    // every tenth entity is a light
+    for (size_t i = 0; i < entities.size(); i += 10) {
+      lights.upsert(entities[i], Light{{}, 1.f});
+    }
+
+    const float64 find_ms = measure_ms([&] {
+      float64 sum = 0.0;
+      meshes.for_each([&](const Entity entity, const Mesh& mesh) {
+        if (const Transform* transform = transforms.find(entity); transform != nullptr) {
+          sum += transform->values[0] + mesh.mesh;
+        }
+      });
+      checksum() += static_cast<uint64>(sum);
+    });
+    const float64 view_ms = measure_ms([&] {
+      float64 sum = 0.0;
+      ComponentView<const Transform, const Mesh>(transforms, meshes)
+          .for_each([&](Entity, const Transform& transform, const Mesh& mesh) {
+            sum += transform.values[0] + mesh.mesh;
+          });
+      checksum() += static_cast<uint64>(sum);
+    });
+
+    const float64 find3_ms = measure_ms([&] {
+      float64 sum = 0.0;
+      lights.for_each([&](const Entity entity, const Light& light) {
+        const Transform* transform = transforms.find(entity);
+        const Mesh* mesh = meshes.find(entity);
+        if (transform != nullptr && mesh != nullptr) {
+          sum += transform->values[0] * light.intensity + mesh->mesh;
+        }
+      });
+      checksum() += static_cast<uint64>(sum);
+    });
+    const float64 view3_ms = measure_ms([&] {
+      float64 sum = 0.0;
+      ComponentView<const Transform, const Mesh, const Light>(transforms, meshes, lights)
+          .for_each([&](Entity, const Transform& transform, const Mesh& mesh, const Light& light) {
+            sum += transform.values[0] * light.intensity + mesh.mesh;
+          });
+      checksum() += static_cast<uint64>(sum);
+    });
+
+    fmt::println("{} entities, {} lights", count, lights.size());
+    report("  transform + mesh, find per entity", find_ms, count);
+    report("  transform + mesh, view", view_ms, count);
+    report("  transform + mesh + light, find per entity", find3_ms, lights.size());
+    report("  transform + mesh + light, view", view3_ms, lights.size());
+  }
+
+}  // namespace
+
+int main() {
+  for (const uint32 count : {10'000u, 100'000u, 1'000'000u}) {
+    run(count);
+  }
+  fmt::println("checksum {}", checksum());
+  return 0;
+}
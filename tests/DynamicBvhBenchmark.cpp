@@ -0,0 +1,175 @@
+﻿#include <limits>
+#include <random>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Benchmark.hpp"
+#include "DynamicBvh.hpp"
+
+// Box, ray and frustum queries against 100k boxes, through the BVH and through a scan over all
+// boxes as callers had to do without it, plus the cost of building and updating the tree. Leaf
+// boxes are enlarged by DynamicBvh::kMargin, so the tree reports a few more hits than the scan.
+
+using namespace gestalt::foundation;
+using namespace gestalt::tests;
+
+namespace {
+
+  constexpr uint32 kObjects = 100'000;
+  constexpr uint32 kQueries = 1'000;
+  constexpr uint32 kFrustums = 100;
+  constexpr float32 kWorldSize = 1000.f;
+
+  bool overlaps(const AABB& a, const AABB& b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y
+           && a.min.z <= b.max.z && b.min.z <= a.max.z;
+  }
+
+  bool hits(const AABB& box, const glm::vec3& origin, const glm::vec3& inverse,
+            const float32 max_distance) {
+    const glm::vec3 t0 = (box.min - origin) * inverse;
+    const glm::vec3 t1 = (box.max - origin) * inverse;
+    const glm::vec3 near = glm::min(t0, t1);
+    const glm::vec3 far = glm::max(t0, t1);
+    return std::max({near.x, near.y, near.z, 0.f})
+           <= std::min({far.x, far.y, far.z, max_distance});
+  }
+
+}  // namespace
+
+int main() {
+  std::mt19937 random(14);
+  std::uniform_real_distribution<float32> position(0.f, kWorldSize);
+  std::uniform_real_distribution<float32> size(0.5f, 4.f);
+  std::uniform_real_distribution<float32> unit(-1.f, 1.f);
+
+  std::vector<AABB> boxes(kObjects);
+  for (AABB& box : boxes) {
+    const glm::vec3 center(position(random), position(random), position(random));
+    const glm::vec3 extent(size(random), size(random), size(random));
+    box.min = center - extent;
+    box.max = center + extent;
+  }
+
+  std::vector<AABB> query_boxes(kQueries);
+  std::vector<glm::vec3> ray_origins(kQueries);
+  std::vector<glm::vec3> ray_directions(kQueries);
+  for (uint32 i = 0; i < kQueries; ++i) {
+    const glm::vec3 center(position(random), position(random), position(random));
+    query_boxes[i].min = center - glm::vec3(20.f);
+    query_boxes[i].max = center + glm::vec3(20.f);
+    ray_origins[i] = glm::vec3(position(random), position(random), position(random));
+    ray_directions[i] = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)));
+  }
+  std::vector<Frustum> frustums(kFrustums);
+  const glm::mat4 projection = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 200.f);
+  for (Frustum& frustum : frustums) {
+    const glm::vec3 eye(position(random), position(random), position(random));
+    const glm::vec3 forward = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)));
+    frustum = Frustum::from_matrix(projection * glm::lookAt(eye, eye + forward, {0.f, 1.f, 0.f}));
+  }
+  constexpr float32 kRayLength = 500.f;
+
+  const float64 insert_ms = measure_ms(
+      [&] {
+        DynamicBvh bvh;
+        for (uint32 i = 0; i < kObjects; ++i) {
+          bvh.update(make_entity(i, 0), boxes[i]);
+        }
+        checksum() += static_cast<uint64>(bvh.height());
+      },
+      3);
+
+  DynamicBvh bvh;
+  for (uint32 i = 0; i < kObjects; ++i) {
+    bvh.update(make_entity(i, 0), boxes[i]);
+  }
+  const int32 inserted_height = bvh.height();
+  const float64 rebuild_ms = measure_ms([&] { bvh.rebuild(); }, 3);
+
+  // a frame of 1% of the objects moving, half within the leaf margin and half further
+  const float64 move_ms = measure_ms([&] {
+    for (uint32 i = 0; i < kObjects; i += 100) {
+      const float32 distance = i % 200 == 0 ? 0.05f : 5.f;
+      boxes[i].min.x += distance;
+      boxes[i].max.x += distance;
+      bvh.update(make_entity(i, 0), boxes[i]);
+    }
+  });
+
+  uint64 bvh_results = 0;
+  uint64 scan_results = 0;
+  const float64 aabb_ms = measure_ms([&] {
+    bvh_results = 0;
+    for (const AABB& query : query_boxes) {
+      bvh.query_aabb(query, [&](Entity) { ++bvh_results; });
+    }
+  });
+  const float64 aabb_scan_ms = measure_ms(
+      [&] {
+        scan_results = 0;
+        for (const AABB& query : query_boxes) {
+          for (const AABB& box : boxes) {
+            scan_results += overlaps(query, box);
+          }
+        }
+      },
+      1);
+  fmt::println("box queries: {} hits through the bvh, {} by the scan", bvh_results,
+               scan_results);
+
+  const float64 ray_ms = measure_ms([&] {
+    bvh_results = 0;
+    for (uint32 i = 0; i < kQueries; ++i) {
+      bvh.query_ray(ray_origins[i], ray_directions[i], kRayLength,
+                    [&](Entity, float32) { ++bvh_results; });
+    }
+  });
+  const float64 ray_scan_ms = measure_ms(
+      [&] {
+        scan_results = 0;
+        for (uint32 i = 0; i < kQueries; ++i) {
+          const glm::vec3 inverse = glm::clamp(1.f / ray_directions[i], glm::vec3(-1e30f),
+                                               glm::vec3(1e30f));
+          for (const AABB& box : boxes) {
+            scan_results += hits(box, ray_origins[i], inverse, kRayLength);
+          }
+        }
+      },
+      1);
+  fmt::println("ray queries: {} hits through the bvh, {} by the scan", bvh_results,
+               scan_results);
+
+  const float64 frustum_ms = measure_ms([&] {
+    bvh_results = 0;
+    for (const Frustum& frustum : frustums) {
+      bvh.query_frustum(frustum, [&](Entity) { ++bvh_results; });
+    }
+  });
+  const float64 frustum_scan_ms = measure_ms([&] {
+    scan_results = 0;
+    for (const Frustum& frustum : frustums) {
+      for (const AABB& box : boxes) {
+        scan_results += frustum.intersects(box.min, box.max);
+      }
+    }
+  });
+  fmt::println("frustum queries: {} hits through the bvh, {} by the scan", bvh_results,
+               scan_results);
+  checksum() += bvh_results + scan_results;
+
+  fmt::println("{} objects, height {} inserted and {} rebuilt", kObjects, inserted_height,
+               bvh.height());
+  report("insert one by one", insert_ms, kObjects);
+  report("rebuild", rebuild_ms, kObjects);
+  report("move 1% of the objects", move_ms, kObjects / 100);
+  report("box query, bvh", aabb_ms, kQueries);
+  report("box query, scan", aabb_scan_ms, kQueries);
+  report("ray query, bvh", ray_ms, kQueries);
+  report("ray query, scan", ray_scan_ms, kQueries);
+  report("frustum query, bvh", frustum_ms, kFrustums);
+  report("frustum query, scan", frustum_scan_ms, kFrustums);
+  fmt::println("checksum {}", checksum());
+  return 0;
+}
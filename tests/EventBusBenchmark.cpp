@@ -0,0 +1,80 @@
+﻿#include <cstdlib>
+#include <new>
+#include <span>
+
+#include "Benchmark.hpp"
+#include "Events/EventBus.hpp"
+
+// 1M events per frame through the event bus, half to a per-event and half to a batch subscriber,
+// counting the heap allocations of the emitting and polling thread per frame. After the queues
+// have grown in the first frames, a frame must not allocate; the benchmark fails if it does.
+
+using namespace gestalt::foundation;
+using namespace gestalt::application;
+using namespace gestalt::tests;
+
+namespace {
+
+  // per thread, so allocations of other threads, e.g. a profiler's, are not counted
+  thread_local uint64 allocations = 0;
+
+  struct MoveEvent {
+    Entity entity;
+    float32 x, y, z;
+  };
+
+  struct DamageEvent {
+    Entity entity;
+    float32 amount;
+  };
+
+  constexpr uint32 kEventsPerFrame = 1'000'000;
+  constexpr uint32 kWarmUpFrames = 2;
+  constexpr uint32 kFrames = 10;
+
+}  // namespace
+
+void* operator new(const size_t size) {
+  ++allocations;
+  if (void* memory = std::malloc(size > 0 ? size : 1); memory != nullptr) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+int main() {
+  EventBus event_bus;
+  float64 moved = 0.0;
+  uint64 damaged = 0;
+  event_bus.subscribe<MoveEvent>([&](const MoveEvent& event) { moved += event.x; });
+  event_bus.subscribe_batch<DamageEvent>(
+      [&](const std::span<const DamageEvent> events) { damaged += events.size(); });
+
+  bool allocated = false;
+  for (uint32 frame = 0; frame < kFrames; ++frame) {
+    const uint64 before = allocations;
+    const float64 ms = measure_ms(
+        [&] {
+          for (uint32 i = 0; i < kEventsPerFrame / 2; ++i) {
+            event_bus.emit(MoveEvent{i, 1.f, 2.f, 3.f});
+            event_bus.emit(DamageEvent{i, 1.f});
+          }
+          event_bus.poll();
+        },
+        1);
+    const uint64 frame_allocations = allocations - before;
+    fmt::println("frame {}: {:.2f} ms, {:.2f} ns per event, {} allocations", frame, ms,
+                 ms * 1e6 / kEventsPerFrame, frame_allocations);
+    allocated |= frame >= kWarmUpFrames && frame_allocations > 0;
+  }
+  fmt::println("checksum {}", static_cast<uint64>(moved) + damaged);
+
+  if (allocated) {
+    fmt::println("frames after the warm-up allocated");
+    return 1;
+  }
+  return 0;
+}
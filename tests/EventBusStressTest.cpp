@@ -0,0 +1,235 @@
+﻿#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "Events/EventBus.hpp"
+
+// Producer lanes of the event bus: several threads emit while another polls, every event carries
+// its producer and a sequence number, so losses, duplicates and reordering show up per producer.
+// Single threaded cases pin down the chunk boundary and the reuse of drained chunks. Run it under
+// ThreadSanitizer and AddressSanitizer as well.
+
+using namespace gestalt::foundation;
+using namespace gestalt::application;
+
+namespace {
+
+  thread_local uint64 allocations = 0;
+
+  struct SequenceEvent {
+    uint32 producer;
+    uint32 sequence;
+  };
+
+  // not trivially destructible, the lanes must destroy every event exactly once
+  struct PayloadEvent {
+    uint32 producer;
+    uint32 sequence;
+    std::vector<uint32> payload;
+  };
+
+  constexpr uint32 kChunkEvents = EventBus::Producer::kChunkEvents;
+
+  uint32 failures = 0;
+
+  template <typename... Args> void check(const bool condition, fmt::format_string<Args...> format,
+                                         Args&&... args) {
+    if (!condition) {
+      fmt::println(format, std::forward<Args>(args)...);
+      ++failures;
+    }
+  }
+
+  /** Expects the sequence numbers of every producer to arrive once each and in order. */
+  class SequenceChecker {
+  public:
+    explicit SequenceChecker(const uint32 producers) : next_(producers, 0) {}
+
+    void receive(const uint32 producer, const uint32 sequence) {
+      if (sequence < next_[producer]) {
+        ++duplicates_;
+      } else if (sequence > next_[producer]) {
+        ++gaps_;
+      }
+      next_[producer] = std::max(next_[producer], sequence + 1);
+      ++received_;
+    }
+
+    void expect(const std::string_view name, const uint32 events_per_producer) const {
+      check(duplicates_ == 0, "{}: {} events arrived twice or out of order", name, duplicates_);
+      check(gaps_ == 0, "{}: {} events arrived after a gap", name, gaps_);
+      for (uint32 producer = 0; producer < next_.size(); ++producer) {
+        check(next_[producer] == events_per_producer, "{}: producer {} delivered {} of {} events",
+              name, producer, next_[producer], events_per_producer);
+      }
+      check(received_ == events_per_producer * next_.size(), "{}: received {} events", name,
+            received_);
+    }
+
+  private:
+    std::vector<uint32> next_;
+    uint64 received_ = 0;
+    uint64 duplicates_ = 0;
+    uint64 gaps_ = 0;
+  };
+
+  void producers_emit_while_polling() {
+    constexpr uint32 kProducers = 8;
+    constexpr uint32 kEvents = 200'000;
+    constexpr uint32 kPayloadEvery = 1000;
+
+    EventBus event_bus;
+    SequenceChecker sequences(kProducers);
+    SequenceChecker payloads(kProducers);
+    bool payload_intact = true;
+    event_bus.subscribe<SequenceEvent>(
+        [&](const SequenceEvent& event) { sequences.receive(event.producer, event.sequence); });
+    event_bus.subscribe<PayloadEvent>([&](const PayloadEvent& event) {
+      payloads.receive(event.producer, event.sequence / kPayloadEvery);
+      payload_intact &= event.payload.size() == 3 && event.payload[2] == event.sequence;
+    });
+
+    std::atomic<bool> done = false;
+    std::thread poller([&] {
+      while (!done.load(std::memory_order_acquire)) {
+        event_bus.poll();
+      }
+    });
+    std::vector<std::thread> producers;
+    for (uint32 p = 0; p < kProducers; ++p) {
+      producers.emplace_back([&event_bus, p] {
+        auto& producer = event_bus.producer(p);
+        for (uint32 i = 0; i < kEvents; ++i) {
+          producer.emit(SequenceEvent{p, i});
+          if (i % kPayloadEvery == 0) {
+            producer.emit(PayloadEvent{p, i, {p, 0, i}});
+          }
+        }
+      });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    done.store(true, std::memory_order_release);
+    poller.join();
+    event_bus.poll();
+
+    sequences.expect("concurrent sequence events", kEvents);
+    payloads.expect("concurrent payload events", kEvents / kPayloadEvery);
+    check(payload_intact, "concurrent payload events: a payload was corrupted");
+  }
+
+  void polls_at_chunk_boundaries() {
+    EventBus event_bus;
+    SequenceChecker sequences(1);
+    event_bus.subscribe<SequenceEvent>(
+        [&](const SequenceEvent& event) { sequences.receive(event.producer, event.sequence); });
+    auto& producer = event_bus.producer(0);
+
+    // a full chunk without a successor: poll must wait for the next one instead of leaving it
+    uint32 sequence = 0;
+    for (; sequence < kChunkEvents; ++sequence) {
+      producer.emit(SequenceEvent{0, sequence});
+    }
+    event_bus.poll();
+    event_bus.poll();
+    producer.emit(SequenceEvent{0, sequence++});
+    event_bus.poll();
+
+    // events that end exactly on the next boundary, then one past it
+    for (; sequence < 2 * kChunkEvents; ++sequence) {
+      producer.emit(SequenceEvent{0, sequence});
+    }
+    event_bus.poll();
+    producer.emit(SequenceEvent{0, sequence++});
+    producer.emit(SequenceEvent{0, sequence++});
+    event_bus.poll();
+
+    sequences.expect("chunk boundaries", sequence);
+  }
+
+  void reuses_drained_chunks() {
+    EventBus event_bus;
+    SequenceChecker sequences(1);
+    event_bus.subscribe<SequenceEvent>(
+        [&](const SequenceEvent& event) { sequences.receive(event.producer, event.sequence); });
+    auto& producer = event_bus.producer(0);
+
+    // four chunks, poll hands the three it left back to the producer
+    uint32 sequence = 0;
+    for (; sequence < 4 * kChunkEvents; ++sequence) {
+      producer.emit(SequenceEvent{0, sequence});
+    }
+    event_bus.poll();
+
+    const uint64 before = allocations;
+    for (const uint32 end = sequence + 3 * kChunkEvents; sequence < end; ++sequence) {
+      producer.emit(SequenceEvent{0, sequence});
+    }
+    check(allocations == before, "reused chunks: emitting allocated {} times",
+          allocations - before);
+    event_bus.poll();
+
+    sequences.expect("reused chunks", sequence);
+  }
+
+  void delivers_in_key_order() {
+    EventBus event_bus;
+    std::vector<uint32> order;
+    event_bus.subscribe<SequenceEvent>(
+        [&](const SequenceEvent& event) { order.push_back(event.producer); });
+
+    std::thread late([&] {
+      auto& producer = event_bus.producer(5);
+      producer.emit(SequenceEvent{5, 0});
+      producer.emit(SequenceEvent{5, 1});
+    });
+    std::thread early([&] { event_bus.producer(1).emit(SequenceEvent{1, 0}); });
+    late.join();
+    early.join();
+    event_bus.emit(SequenceEvent{0, 0});
+    event_bus.poll();
+
+    check(order == std::vector<uint32>{0, 1, 5, 5},
+          "key order: the polling thread's events and then producers by key were expected");
+  }
+
+  void destroys_undelivered_events() {
+    // leaves a payload in the lane, AddressSanitizer reports it if the lane leaks it
+    EventBus event_bus;
+    event_bus.producer(0).emit(PayloadEvent{0, 0, std::vector<uint32>(16)});
+  }
+
+}  // namespace
+
+void* operator new(const size_t size) {
+  ++allocations;
+  if (void* memory = std::malloc(size > 0 ? size : 1); memory != nullptr) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+int main() {
+  producers_emit_while_polling();
+  polls_at_chunk_boundaries();
+  reuses_drained_chunks();
+  delivers_in_key_order();
+  destroys_undelivered_events();
+
+  if (failures > 0) {
+    fmt::println("{} checks failed", failures);
+    return 1;
+  }
+  fmt::println("all checks passed");
+  return 0;
+}
@@ -0,0 +1,134 @@
+﻿#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Animation/CompiledTrack.hpp"
+
+// Finding the keys around the playback time of keyed tracks: CompiledTrack::locate with a cursor
+// per channel against the scan from the first key that animation sampling did before, and a
+// binary search. 2000 channels of 5000 keys each, started at different times, are played for
+// 600 frames. Random seeks check that the cursor finds the same segment as the scan.
+
+using namespace gestalt::foundation;
+using namespace gestalt::tests;
+
+namespace {
+
+  constexpr uint32 kChannels = 2000;
+  constexpr uint32 kKeys = 5000;
+  constexpr uint32 kFrames = 600;
+  constexpr float32 kKeyRate = 30.f;
+  constexpr float32 kPlaybackRate = 5.f;  // seconds of animation per second of frames
+
+  size_t scan(const std::vector<float32>& times, const float32 time) {
+    const size_t last = times.size() - 2;
+    for (size_t i = 0; i < last; ++i) {
+      if (time < times[i + 1]) {
+        return i;
+      }
+    }
+    return last;
+  }
+
+  size_t binary_search(const std::vector<float32>& times, const float32 time) {
+    const auto next = std::upper_bound(times.begin(), times.end(), time);
+    return std::clamp<size_t>(static_cast<size_t>(next - times.begin()), 1, times.size() - 1) - 1;
+  }
+
+  float32 frame_time(const uint32 frame, const float32 offset) {
+    return offset + static_cast<float32>(frame) / 60.f * kPlaybackRate;
+  }
+
+  CompiledTrack<glm::vec3> create_track(std::mt19937& random) {
+    std::uniform_real_distribution<float32> unit(-1.f, 1.f);
+    CompiledTrack<glm::vec3> track;
+    track.times.reserve(kKeys);
+    track.values.reserve(kKeys);
+    for (uint32 i = 0; i < kKeys; ++i) {
+      track.times.push_back(static_cast<float32>(i) / kKeyRate);
+      track.values.emplace_back(unit(random), unit(random), unit(random));
+    }
+    track.start_time = track.times.front();
+    track.end_time = track.times.back();
+    return track;
+  }
+
+}  // namespace
+
+int main() {
+  std::mt19937 random(24);
+  std::uniform_real_distribution<float32> unit(-1.f, 1.f);
+
+  // every channel owns its keys, as the channels of different nodes do
+  std::vector<CompiledTrack<glm::vec3>> tracks;
+  std::vector<float32> offsets;
+  for (uint32 channel = 0; channel < kChannels; ++channel) {
+    tracks.push_back(create_track(random));
+    offsets.push_back((unit(random) + 1.f) * 0.25f * tracks.back().end_time);
+  }
+  const CompiledTrack<glm::vec3>& track = tracks.front();
+
+  // random seeks and steady playback, the segment of the cursor against the scan
+  uint64 mismatches = 0;
+  size_t cursor = 0;
+  float32 time = 0.f;
+  for (uint32 i = 0; i < 200'000; ++i) {
+    if (i % 100 == 0) {
+      time = (unit(random) * 0.6f + 0.5f) * track.end_time;
+    } else {
+      time += (unit(random) + 1.f) * 0.025f;
+    }
+    mismatches += track.locate(time, cursor).from != scan(track.times, time);
+  }
+
+  std::vector<size_t> cursors(kChannels, 0);
+  const float64 cursor_ms = measure_ms(
+      [&] {
+        std::ranges::fill(cursors, 0);
+        uint64 sum = 0;
+        for (uint32 frame = 0; frame < kFrames; ++frame) {
+          for (uint32 channel = 0; channel < kChannels; ++channel) {
+            sum += tracks[channel].locate(frame_time(frame, offsets[channel]), cursors[channel])
+                       .from;
+          }
+        }
+        checksum() += sum;
+      },
+      3);
+  const float64 binary_ms = measure_ms(
+      [&] {
+        uint64 sum = 0;
+        for (uint32 frame = 0; frame < kFrames; ++frame) {
+          for (uint32 channel = 0; channel < kChannels; ++channel) {
+            sum += binary_search(tracks[channel].times, frame_time(frame, offsets[channel]));
+          }
+        }
+        checksum() += sum;
+      },
+      3);
+  const float64 scan_ms = measure_ms(
+      [&] {
+        uint64 sum = 0;
+        for (uint32 frame = 0; frame < kFrames; ++frame) {
+          for (uint32 channel = 0; channel < kChannels; ++channel) {
+            sum += scan(tracks[channel].times, frame_time(frame, offsets[channel]));
+          }
+        }
+        checksum() += sum;
+      },
+      1);
+
+  const uint64 lookups = static_cast<uint64>(kChannels) * kFrames;
+  fmt::println("{} channels of {} keys, {} frames", kChannels, kKeys, kFrames);
+  report("cursor", cursor_ms, lookups);
+  report("binary search", binary_ms, lookups);
+  report("scan from the first key", scan_ms, lookups);
+  fmt::println("checksum {}", checksum());
+
+  if (mismatches > 0) {
+    fmt::println("the cursor found another segment than the scan {} times", mismatches);
+    return 1;
+  }
+  return 0;
+}
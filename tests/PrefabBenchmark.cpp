@@ -0,0 +1,99 @@
+﻿#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Repository.hpp"
+#include "ECS/ComponentFactory.hpp"
+#include "Events/EventBus.hpp"
+
+// 10k copies of a 21 node prefab through ComponentFactory::instantiate against creating every
+// node of every copy on its own and linking it to its parent, as a scene import does.
+
+using namespace gestalt::foundation;
+using namespace gestalt::application;
+using namespace gestalt::tests;
+
+namespace {
+
+  constexpr size_t kCopies = 10'000;
+  constexpr uint32 kRuns = 3;
+
+  bool counts_mismatched = false;
+
+  struct PrefabNode {
+    uint32 parent;  // index into the prefab, the root's is unused
+    glm::vec3 position;
+  };
+
+  // a root with four children of four children each, every node with a mesh
+  std::vector<PrefabNode> prefab_layout() {
+    std::vector<PrefabNode> layout{{0, glm::vec3(0.f)}};
+    for (uint32 child = 0; child < 4; ++child) {
+      const auto child_index = static_cast<uint32>(layout.size());
+      layout.push_back({0, glm::vec3(static_cast<float32>(child), 0.f, 0.f)});
+      for (uint32 grandchild = 0; grandchild < 4; ++grandchild) {
+        layout.push_back({child_index, glm::vec3(0.f, static_cast<float32>(grandchild), 0.f)});
+      }
+    }
+    return layout;
+  }
+
+  Entity create_copy(ComponentFactory& factory, const std::vector<PrefabNode>& layout) {
+    std::vector<Entity> entities(layout.size());
+    for (size_t i = 0; i < layout.size(); ++i) {
+      entities[i] = factory.create_entity({}, layout[i].position).first;
+      factory.add_mesh_component(entities[i], 0);
+      factory.link_entity_to_parent(entities[i],
+                                    i == 0 ? root_entity : entities[layout[i].parent]);
+    }
+    return entities.front();
+  }
+
+  /** Fastest of kRuns spawns, each into a new repository that holds only the prefab. */
+  template <typename Spawn> float64 spawn_ms(const std::vector<PrefabNode>& layout, Spawn&& spawn) {
+    float64 best = std::numeric_limits<float64>::max();
+    for (uint32 run = 0; run < kRuns; ++run) {
+      const auto repository = std::make_unique<Repository>();
+      EventBus event_bus;
+      ComponentFactory factory(*repository, event_bus);
+      const Entity prefab = create_copy(factory, layout);
+
+      best = std::min(best, measure_ms([&] { spawn(factory, prefab); }, 1));
+
+      const size_t expected_meshes = layout.size() * (kCopies + 1);
+      const size_t expected_nodes = 1 + expected_meshes;
+      if (repository->scene_graph.size() != expected_nodes
+          || repository->mesh_components.size() != expected_meshes) {
+        fmt::println("expected {} nodes and {} meshes, found {} and {}", expected_nodes,
+                     expected_meshes, repository->scene_graph.size(),
+                     repository->mesh_components.size());
+        counts_mismatched = true;
+      }
+      checksum() += repository->scene_graph.size();
+    }
+    return best;
+  }
+
+}  // namespace
+
+int main() {
+  const std::vector<PrefabNode> layout = prefab_layout();
+
+  const float64 node_by_node_ms = spawn_ms(layout, [&](ComponentFactory& factory, Entity) {
+    for (size_t copy = 0; copy < kCopies; ++copy) {
+      create_copy(factory, layout);
+    }
+  });
+  const float64 instantiate_ms = spawn_ms(layout, [&](ComponentFactory& factory, Entity prefab) {
+    checksum() += factory.instantiate(prefab, kCopies).size();
+  });
+
+  const uint64 nodes = kCopies * layout.size();
+  fmt::println("{} copies of a {} node prefab", kCopies, layout.size());
+  report("node by node", node_by_node_ms, nodes);
+  report("instantiate", instantiate_ms, nodes);
+  fmt::println("checksum {}", checksum());
+  return counts_mismatched ? 1 : 0;
+}
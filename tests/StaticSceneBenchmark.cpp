@@ -0,0 +1,132 @@
+﻿#include <random>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Benchmark.hpp"
+#include "DynamicBvh.hpp"
+
+// A mostly static scene, 100k objects of which 2% move every frame, kept in one BVH against the
+// split the transform system uses: static objects in a tree that is built once and movers in a
+// tree of their own. Each frame updates the movers and runs box and frustum queries, timed over a
+// few hundred frames so the degradation of incrementally updated trees shows.
+
+using namespace gestalt::foundation;
+using namespace gestalt::tests;
+
+namespace {
+
+  constexpr uint32 kObjects = 100'000;
+  constexpr uint32 kMoverEvery = 50;  // every 50th object moves, 2%
+  constexpr uint32 kFrames = 300;
+  constexpr uint32 kBoxQueries = 100;
+  constexpr float32 kWorldSize = 1000.f;
+
+  struct Scene {
+    std::vector<AABB> boxes;
+    std::vector<glm::vec3> velocities;
+    std::vector<AABB> query_boxes;
+    std::vector<Frustum> frustums;
+  };
+
+  struct Result {
+    float64 update_ms = 0.0;
+    float64 query_ms = 0.0;
+    uint64 hits = 0;
+  };
+
+  bool is_mover(const uint32 i) { return i % kMoverEvery == 0; }
+
+  Scene create_scene() {
+    std::mt19937 random(18);
+    std::uniform_real_distribution<float32> position(0.f, kWorldSize);
+    std::uniform_real_distribution<float32> size(0.5f, 4.f);
+    std::uniform_real_distribution<float32> unit(-1.f, 1.f);
+
+    Scene scene;
+    scene.boxes.resize(kObjects);
+    scene.velocities.resize(kObjects);
+    for (uint32 i = 0; i < kObjects; ++i) {
+      const glm::vec3 center(position(random), position(random), position(random));
+      const glm::vec3 extent(size(random), size(random), size(random));
+      scene.boxes[i].min = center - extent;
+      scene.boxes[i].max = center + extent;
+      scene.velocities[i] = glm::vec3(unit(random), unit(random), unit(random));
+    }
+    for (uint32 i = 0; i < kBoxQueries; ++i) {
+      const glm::vec3 center(position(random), position(random), position(random));
+      scene.query_boxes.push_back({center - glm::vec3(20.f), center + glm::vec3(20.f)});
+    }
+    const glm::mat4 projection = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 200.f);
+    for (uint32 i = 0; i < 4; ++i) {
+      const glm::vec3 eye(position(random), position(random), position(random));
+      const glm::vec3 forward = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)));
+      scene.frustums.push_back(
+          Frustum::from_matrix(projection * glm::lookAt(eye, eye + forward, {0.f, 1.f, 0.f})));
+    }
+    return scene;
+  }
+
+  /** Runs kFrames frames, static_bvh is the same tree as movable_bvh for the single tree. */
+  Result run(Scene scene, DynamicBvh& movable_bvh, DynamicBvh& static_bvh) {
+    for (uint32 i = 0; i < kObjects; ++i) {
+      (is_mover(i) ? movable_bvh : static_bvh).update(make_entity(i, 0), scene.boxes[i]);
+    }
+    movable_bvh.rebuild();
+    if (&static_bvh != &movable_bvh) {
+      static_bvh.rebuild();
+    }
+
+    Result result;
+    const auto trees = &static_bvh != &movable_bvh ? std::vector{&static_bvh, &movable_bvh}
+                                                   : std::vector{&movable_bvh};
+    for (uint32 frame = 0; frame < kFrames; ++frame) {
+      result.update_ms += measure_ms(
+          [&] {
+            for (uint32 i = 0; i < kObjects; i += kMoverEvery) {
+              scene.boxes[i].min += scene.velocities[i];
+              scene.boxes[i].max += scene.velocities[i];
+              movable_bvh.update(make_entity(i, 0), scene.boxes[i]);
+            }
+          },
+          1);
+      result.query_ms += measure_ms(
+          [&] {
+            for (const DynamicBvh* tree : trees) {
+              for (const AABB& query : scene.query_boxes) {
+                tree->query_aabb(query, [&](Entity) { ++result.hits; });
+              }
+              for (const Frustum& frustum : scene.frustums) {
+                tree->query_frustum(frustum, [&](Entity) { ++result.hits; });
+              }
+            }
+          },
+          1);
+    }
+    return result;
+  }
+
+}  // namespace
+
+int main() {
+  const Scene scene = create_scene();
+
+  DynamicBvh single;
+  const Result one_tree = run(scene, single, single);
+
+  DynamicBvh movable;
+  DynamicBvh fixed;
+  const Result split = run(scene, movable, fixed);
+
+  fmt::println("{} objects, {} moving, {} frames, {} box and {} frustum queries per frame",
+               kObjects, kObjects / kMoverEvery, kFrames, kBoxQueries, scene.frustums.size());
+  fmt::println("hits: {} in one tree, {} in the split trees", one_tree.hits, split.hits);
+  report("one tree, update movers", one_tree.update_ms, kFrames);
+  report("split trees, update movers", split.update_ms, kFrames);
+  report("one tree, queries", one_tree.query_ms, kFrames);
+  report("split trees, queries", split.query_ms, kFrames);
+  report("one tree, frame total", one_tree.update_ms + one_tree.query_ms, kFrames);
+  report("split trees, frame total", split.update_ms + split.query_ms, kFrames);
+  fmt::println("checksum {}", one_tree.hits + split.hits);
+  return 0;
+}
@@ -0,0 +1,142 @@
+﻿#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "Benchmark.hpp"
+#include "TransformBatch.hpp"
+
+// The batch kernels against the per-node code they replaced in the transform system: composing a
+// world transform from the parent's and applying Arvo's method to a local box, one node at a time
+// on glm types. The batches run on the widest instruction set the CPU supports.
+
+using namespace gestalt::foundation;
+using namespace gestalt::tests;
+
+namespace {
+
+  struct Node {
+    glm::vec3 position;
+    glm::quat rotation;
+    float32 scale;
+  };
+
+  struct Box {
+    glm::vec3 min;
+    glm::vec3 max;
+  };
+
+  Node compose(const Node& parent, const Node& local) {
+    return {parent.position + parent.rotation * (parent.scale * local.position),
+            parent.rotation * local.rotation, parent.scale * local.scale};
+  }
+
+  Box transform_box(const Box& local, const Node& world) {
+    const glm::mat3 m = glm::transpose(glm::mat3_cast(world.rotation));
+    Box transformed = {world.position, world.position};
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        const float32 a = m[i][j] * world.scale * local.min[j];
+        const float32 b = m[i][j] * world.scale * local.max[j];
+        transformed.min[i] += a < b ? a : b;
+        transformed.max[i] += a < b ? b : a;
+      }
+    }
+    return transformed;
+  }
+
+  const char* level_name(const SimdLevel level) {
+    switch (level) {
+      case SimdLevel::kAvx2:
+        return "AVX2";
+      case SimdLevel::kSse:
+        return "SSE";
+      default:
+        return "scalar";
+    }
+  }
+
+  void run(const uint32 count) {
+    std::mt19937 random(count);
+    std::uniform_real_distribution<float32> unit(-1.f, 1.f);
+    const auto random_node = [&] {
+      const glm::quat rotation = glm::normalize(
+          glm::quat(unit(random), unit(random), unit(random), unit(random) + 2.f));
+      return Node{{unit(random) * 10.f, unit(random) * 10.f, unit(random) * 10.f}, rotation,
+                  1.f + unit(random) * 0.5f};
+    };
+
+    std::vector<Node> parents(count);
+    std::vector<Node> locals(count);
+    std::vector<Box> boxes(count);
+    TransformBatch parent_batch;
+    TransformBatch local_batch;
+    BoundsBatch box_batch;
+    parent_batch.resize(count);
+    local_batch.resize(count);
+    box_batch.resize(count);
+    for (uint32 i = 0; i < count; ++i) {
+      parents[i] = random_node();
+      locals[i] = random_node();
+      const glm::vec3 center(unit(random), unit(random), unit(random));
+      const glm::vec3 extent = glm::vec3(1.5f) + glm::vec3(unit(random), unit(random), unit(random));
+      boxes[i] = {center - extent, center + extent};
+      parent_batch.set(i, parents[i].position, parents[i].rotation, parents[i].scale);
+      local_batch.set(i, locals[i].position, locals[i].rotation, locals[i].scale);
+      box_batch.set(i, center, extent);
+    }
+
+    std::vector<Node> worlds(count);
+    const float64 compose_ms = measure_ms([&] {
+      for (uint32 i = 0; i < count; ++i) {
+        worlds[i] = compose(parents[i], locals[i]);
+      }
+      checksum() += static_cast<uint64>(worlds.back().scale * 1000.f);
+    });
+    TransformBatch world_batch;
+    const float64 compose_batch_ms = measure_ms([&] {
+      compose_transforms(parent_batch, local_batch, world_batch);
+      checksum() += static_cast<uint64>(world_batch.scale.back() * 1000.f);
+    });
+
+    std::vector<Box> results(count);
+    const float64 bounds_ms = measure_ms([&] {
+      for (uint32 i = 0; i < count; ++i) {
+        results[i] = transform_box(boxes[i], worlds[i]);
+      }
+      checksum() += static_cast<uint64>(std::abs(results.back().max.x));
+    });
+    BoundsBatch result_batch;
+    const float64 bounds_batch_ms = measure_ms([&] {
+      transform_bounds(world_batch, box_batch, result_batch);
+      checksum() += static_cast<uint64>(std::abs(result_batch.center_x.back()));
+    });
+
+    // both paths compute the same values, up to rounding
+    float32 error = 0.f;
+    for (uint32 i = 0; i < count; ++i) {
+      error = std::max(error, glm::length(world_batch.position(i) - worlds[i].position));
+      error = std::max(error, glm::length(result_batch.center(i) + result_batch.extent(i)
+                                          - results[i].max));
+    }
+
+    fmt::println("{} nodes, largest difference {:.2e}", count, error);
+    report("  compose, per node", compose_ms, count);
+    report("  compose, batch", compose_batch_ms, count);
+    report("  bounds, per node", bounds_ms, count);
+    report("  bounds, batch", bounds_batch_ms, count);
+  }
+
+}  // namespace
+
+int main() {
+  fmt::println("batch kernels use {}", level_name(transform_batch_simd_level()));
+  for (const uint32 count : {10'000u, 100'000u, 1'000'000u}) {
+    run(count);
+  }
+  fmt::println("checksum {}", checksum());
+  return 0;
+}